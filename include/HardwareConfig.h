@@ -20,6 +20,31 @@
 #define LCD_I2C_ADDRESS 0x27    // LCD I2C Display
 #define ADS1115_ADDRESS 0x48    // ADS1115 ADC
 
+// ADS1115 channels
+#define ADS1115_CH_HEATER_TEMP 0    // 10k NTC to GND, 10k to 3.3V (drying heater)
+#define ADS1115_CH_VACUUM 1         // Vacuum line pressure transducer
+#define ADS1115_CH_SHREDDER_CURRENT 2  // Shredder motor current clamp
+#define ADS1115_CH_MIXER_CURRENT 3     // Mixer motor current clamp
+
+// Vacuum transducer (MPXV6115V through a 2:3 divider) - vacuum lowers the output
+#define VACUUM_ZERO_VOLTS 3.07f     // At atmosphere
+#define VACUUM_KPA_PER_VOLT 39.2f
+
+// Motor current clamps (DC output, 0 V at no current)
+#define SHREDDER_AMPS_PER_VOLT 10.0f
+#define MIXER_AMPS_PER_VOLT 10.0f
+#define SHREDDER_JAM_AMPS 12.0f     // Until the running current has been learned
+#define MIXER_JAM_AMPS 8.0f
+
+// Mains supply - total current the feed carries through a motor start
+#define SUPPLY_BUDGET_AMPS 40.0f
+
+// Forward/Reverse relay (PCF8575 #2 P6): 0 = stock wiring, it reverses the
+// shredder and the moulder runs single mould A only. 1 = it drives the
+// dual-mould carriage - only set this once the shredder reversing contactor
+// is rewired to Spare 3 (PCF8575 #1 P3). Check with Test > Shredder Rev.
+#define FWD_REV_MOULD_CARRIAGE 0
+
 // ==================== DIRECT GPIO PINS (ESP32-WROOM DevKit) ====================
 
 // Button pins (use GPIOs with internal pullups)
@@ -31,12 +56,16 @@
 #define SENSOR_WATER_FLOW 32
 #define SENSOR_IR_TRAY 19
 
+// ADS1115 ALERT/RDY (conversion ready, open drain)
+#define ADS1115_ALERT_PIN 4
+
 // Servo pin
 #define SERVO_PIN 33
 
 // HX711 Load Cell Amplifier
 #define HX711_DOUT_PIN 16
 #define HX711_SCK_PIN 17
+#define HX711_RATE_SPS 10       // Board RATE pin: low = 10 SPS, high = 80 SPS
 
 // ==================== PCF8575 OBJECTS ====================
 
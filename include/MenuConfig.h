@@ -15,6 +15,10 @@ void exitTestMode();
 void saveSettings();
 void resetToDefaults();
 
+// Recipes
+void selectNextRecipe();
+void saveCustomRecipe();
+
 // Relay toggle functions
 void toggleRelay0();
 void toggleRelay1();
@@ -40,14 +44,25 @@ void toggleRelay20();
 void toggleRelay21();
 void toggleRelay22();
 void toggleRelay23();
+void toggleShredderReverse();       // Wherever FWD_REV_MOULD_CARRIAGE puts it
 
 // Servo control functions
 void toggleServo();
 
+// Water dosing
+void startWaterDose();
+void calibrateFlowMeter();
+
+// Drying heater
+void heaterAutoTune();
+
 // Scale calibration functions
 void startScaleCalibration();
 void calibrateScaleZero();
 void calibrateScaleWithWeight();
+void calibrateScaleAddPoint();
+void calibrateTankZero();
+void calibrateTankWithWeight();
 void saveScaleCalibration();
 
 // External references to relay states
@@ -58,18 +73,32 @@ extern int servoAngle;
 // External references to settings variables
 extern int waterAmount;
 extern int waterFlowTimeout;
+extern int flowCalAmount;
 extern int starchWeight;
 extern int starchDispenseTime;
 extern int shredderTime;
 extern int mixTime;
 extern int mixSpeed;
+extern bool mixAutoEnd;
 extern int pumpTime;
 extern int mouldSuctionTime;
 extern int mouldBlowerTime;
 extern int mouldCycleDelay;
+extern bool dualMould;
+extern bool suctionAutoEnd;
 extern int dryingTime;
 extern int dryingTemp;
 extern int conveyorSpeed;
+extern int rejectDistance1;
+extern int rejectDistance2;
+extern int rejectPulseTime;
+extern int scaleCalibrationWeight;
+extern bool scaleTempComp;
+extern bool scaleZeroTrack;
+extern int scaleZeroBand;
+extern int scaleZeroLimit;
+extern bool tankScaleEnabled;
+extern int tankCalibrationWeight;
 extern bool testMode;
 
 // Menu items declarations
@@ -81,6 +110,7 @@ extern MenuItem shredderMenuItems[];
 extern MenuItem mixerMenuItems[];
 extern MenuItem mouldingMenuItems[];
 extern MenuItem dryingMenuItems[];
+extern MenuItem conveyorMenuItems[];
 extern MenuItem scaleCalMenuItems[];
 extern MenuItem testMenuItems[];
 extern MenuItem runningMenuItems[];
@@ -89,18 +119,19 @@ extern MenuItem runningMenuItems[];
 extern MenuLayer menuLayers[];
 
 // Menu counts
-#define MAIN_MENU_COUNT 3
-#define SETTINGS_MENU_COUNT 9
-#define WATER_MENU_COUNT 3
+#define MAIN_MENU_COUNT 4
+#define SETTINGS_MENU_COUNT 11
+#define WATER_MENU_COUNT 6
 #define STARCH_MENU_COUNT 3
 #define SHREDDER_MENU_COUNT 2
-#define MIXER_MENU_COUNT 3
-#define MOULDING_MENU_COUNT 4
-#define DRYING_MENU_COUNT 3
-#define SCALE_CAL_MENU_COUNT 4
-#define TEST_MENU_COUNT 19
+#define MIXER_MENU_COUNT 4
+#define MOULDING_MENU_COUNT 6
+#define DRYING_MENU_COUNT 4
+#define CONVEYOR_MENU_COUNT 5
+#define SCALE_CAL_MENU_COUNT 13
+#define TEST_MENU_COUNT 20
 #define RUNNING_MENU_COUNT 1
-#define TOTAL_LAYERS 11
+#define TOTAL_LAYERS 12
 
 // Function to link all submenus
 void linkMenus();
@@ -10,7 +10,7 @@
  * P0  = Relay 1   (Spare 1)
  * P1  = Relay 2   (Spare 2)
  * P2  = Relay 3   (Linear Door)
- * P3  = Relay 4   (Spare 3)
+ * P3  = Relay 4   (Spare 3 - shredder reverse with the carriage, see below)
  * P4  = Relay 5   (Defective 1)
  * P5  = Relay 6   (Conveyor)
  * P6  = Relay 7   (Screw)
@@ -37,8 +37,8 @@
  * P3  = Relay 4   (Vacuum - A/B)
  * P4  = Relay 5   (Blower - A/B)
  * P5  = Relay 6   (Mould B - Vacuum/Blower)
- * P6  = Relay 7   (Forward/Reverse)
- * P7  = Relay 8   (Up/Down)
+ * P6  = Relay 7   (Forward/Reverse - mould carriage, see below)
+ * P7  = Relay 8   (Up/Down - mould lift)
  * P8  = Input     (Enter Button)
  * P9  = Input     (Up Button)
  * P10 = Input     (Down Button)
@@ -53,6 +53,11 @@
  * - All button inputs use internal pullup (pressed = LOW, released = HIGH)
  * - Flow sensor generates pulses (LOW pulse per rotation)
  * - IR sensor is active LOW (LOW = tray detected, HIGH = no tray)
+ * - Up/Down lowers the vat mould into the pulp (on = down)
+ * - Forward/Reverse reverses the shredder (stock wiring). With
+ *   FWD_REV_MOULD_CARRIAGE set in HardwareConfig.h it moves the dual-mould
+ *   carriage instead (off = A over the vat), and the shredder reversing
+ *   contactor must be rewired to Spare 3 (PCF8575 #1 P3)
  */
 
 #ifndef PCF8575_PINMAP_H
@@ -87,6 +92,33 @@
 #define RELAY_FORWARD_REVERSE      P6
 #define RELAY_UP_DOWN              P7
 
+// Flat relay indices used by setRelay() and relayStates[]
+// (0-15 = PCF8575 #1 P0..P15, 16-23 = PCF8575 #2 P0..P7)
+#define RELAY_IDX_SPARE_1              0
+#define RELAY_IDX_SPARE_2              1
+#define RELAY_IDX_LINEAR               2
+#define RELAY_IDX_SPARE_3              3
+#define RELAY_IDX_DEFECTIVE_1          4
+#define RELAY_IDX_CONVEYOR             5
+#define RELAY_IDX_SCREW                6
+#define RELAY_IDX_DEFECTIVE_2          7
+#define RELAY_IDX_SHREDDER_POWER       8
+#define RELAY_IDX_PUMP                 9
+#define RELAY_IDX_MIXER                10
+#define RELAY_IDX_SHREDDER_MAIN_POWER  11
+#define RELAY_IDX_VALVE                12
+#define RELAY_IDX_SPARE_4              13
+#define RELAY_IDX_HEATER               14
+#define RELAY_IDX_SPARE_5              15
+#define RELAY_IDX_VACUUM               16
+#define RELAY_IDX_BLOWER               17
+#define RELAY_IDX_MOULD_A_VAC_BLOW     18
+#define RELAY_IDX_VACUUM_AB            19
+#define RELAY_IDX_BLOWER_AB            20
+#define RELAY_IDX_MOULD_B_VAC_BLOW     21
+#define RELAY_IDX_FORWARD_REVERSE      22
+#define RELAY_IDX_UP_DOWN              23
+
 // Note: Buttons and sensors use direct ESP32 GPIO pins
 // See HardwareConfig.h for:
 // - BTN_UP (GPIO 25)
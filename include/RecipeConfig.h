@@ -0,0 +1,29 @@
+/*
+ * Recipe Configuration
+ * Built-in production recipes and the settings they can read live
+ */
+
+#ifndef RECIPECONFIG_H
+#define RECIPECONFIG_H
+
+#include <RecipeEngine.h>
+
+// Settings a recipe step can take its value from (RecipeStep.source)
+enum RecipeSetting {
+    RECIPE_SET_FIXED = RECIPE_SOURCE_FIXED,
+    RECIPE_SET_WATER_AMOUNT,
+    RECIPE_SET_STARCH_WEIGHT,
+    RECIPE_SET_SHREDDER_TIME,
+    RECIPE_SET_MIX_TIME,
+    RECIPE_SET_PUMP_TIME,
+    RECIPE_SET_MOULD_SUCTION,
+    RECIPE_SET_DRYING_TIME,
+    RECIPE_SET_COUNT
+};
+
+#define BUILTIN_RECIPE_COUNT 3
+
+extern const int* const recipeSettings[RECIPE_SET_COUNT];
+extern const Recipe builtInRecipes[BUILTIN_RECIPE_COUNT];
+
+#endif // RECIPECONFIG_H
@@ -11,6 +11,7 @@
 // ==================== WATER SETTINGS ====================
 extern int waterAmount;          // ml
 extern int waterFlowTimeout;     // seconds
+extern int flowCalAmount;        // grams - water weighed for K-factor calibration
 
 // ==================== STARCH SETTINGS ====================
 extern int starchWeight;         // grams
@@ -22,6 +23,7 @@ extern int shredderTime;         // seconds
 // ==================== MIXER SETTINGS ====================
 extern int mixTime;              // seconds
 extern int mixSpeed;             // percentage
+extern bool mixAutoEnd;          // End mixing once the motor current settles (time = upper bound)
 
 // ==================== PULP PUMP ====================
 extern int pumpTime;             // seconds
@@ -30,6 +32,8 @@ extern int pumpTime;             // seconds
 extern int mouldSuctionTime;     // seconds
 extern int mouldBlowerTime;      // seconds
 extern int mouldCycleDelay;      // seconds
+extern bool dualMould;           // Mould A/B ping-pong (false = mould A only)
+extern bool suctionAutoEnd;      // End suction at the vacuum plateau (time = upper bound)
 
 // ==================== DRYING SETTINGS ====================
 extern int dryingTime;           // seconds
@@ -37,9 +41,18 @@ extern int dryingTemp;           // degrees C
 
 // ==================== CONVEYOR ====================
 extern int conveyorSpeed;        // percentage
+extern int rejectDistance1;      // ms of conveyor run from IR sensor to Defective 1
+extern int rejectDistance2;      // ms of conveyor run from IR sensor to Defective 2
+extern int rejectPulseTime;      // ms reject relay on time
 
 // ==================== SCALE CALIBRATION ====================
 extern int scaleCalibrationWeight; // grams - known weight for calibration
+extern bool scaleTempComp;         // NAU7802 temperature drift compensation
+extern bool scaleZeroTrack;        // Automatic zero tracking while idle
+extern int scaleZeroBand;          // grams - track only within +/- band of zero
+extern int scaleZeroLimit;         // grams - max total tracked correction
+extern bool tankScaleEnabled;      // Pulp tank load cell on NAU7802 channel 2
+extern int tankCalibrationWeight;  // grams - known weight for tank calibration
 
 // ==================== SYSTEM STATE ====================
 extern bool testMode;
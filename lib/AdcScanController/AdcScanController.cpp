@@ -0,0 +1,195 @@
+/*
+ * ADC Scan Controller Implementation
+ */
+
+#include "AdcScanController.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+AdcScanController* AdcScanController::instance = nullptr;
+
+// Conversion rate for each RATE_ADS1115_xxSPS setting (bits 7:5)
+static const uint16_t ADS1115_SPS[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+
+AdcScanController::AdcScanController() {
+    ads = nullptr;
+    alertPin = -1;
+    initialized = false;
+    running = false;
+    memset(channels, 0, sizeof(channels));
+    memset(readings, 0, sizeof(readings));
+    channelCount = 0;
+    current = 0;
+    selectTime = 0;
+    readTimeout = 0;
+    scanCount = 0;
+    missedReady = 0;
+    readyFlag = false;
+    readyTime = 0;
+    mux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+bool AdcScanController::init(Adafruit_ADS1115* adc, int8_t pin) {
+    ads = adc;
+    alertPin = pin;
+    if (ads == nullptr) {
+        logger.error("ADC", "No ADS1115 - scan disabled");
+        return false;
+    }
+
+    if (alertPin >= 0) {
+        // ALERT/RDY is open drain, pulses low for each conversion
+        pinMode(alertPin, INPUT_PULLUP);
+        instance = this;
+        attachInterrupt(digitalPinToInterrupt(alertPin), readyISR, FALLING);
+        logger.info("ADC", "ALERT/RDY on pin", alertPin);
+    } else {
+        logger.warning("ADC", "No ALERT/RDY pin - timed reads");
+    }
+    initialized = true;
+    return true;
+}
+
+int8_t AdcScanController::addChannel(const AdcChannelConfig& config) {
+    if (channelCount >= MAX_CHANNELS) {
+        logger.error("ADC", "Scan list full");
+        return -1;
+    }
+    channels[channelCount] = config;
+    filters[channelCount].configure(config.filter);
+    memset(&readings[channelCount], 0, sizeof(AdcReading));
+    logger.info("ADC", "Scanning", config.name);
+    return channelCount++;
+}
+
+void AdcScanController::start() {
+    if (!initialized || channelCount == 0) return;
+    for (uint8_t i = 0; i < channelCount; i++) {
+        filters[i].reset();
+    }
+    running = true;
+    selectChannel(0);
+}
+
+void AdcScanController::stop() {
+    running = false;
+}
+
+void IRAM_ATTR AdcScanController::readyISR() {
+    if (instance == nullptr) return;
+    uint32_t now = micros();
+    portENTER_CRITICAL_ISR(&instance->mux);
+    instance->readyFlag = true;
+    instance->readyTime = now;
+    portEXIT_CRITICAL_ISR(&instance->mux);
+}
+
+void AdcScanController::update() {
+    if (!running) return;
+
+    portENTER_CRITICAL(&mux);
+    bool ready = readyFlag;
+    uint32_t timeUs = readyTime;
+    readyFlag = false;
+    portEXIT_CRITICAL(&mux);
+
+    if (!ready) {
+        // No RDY pin, or the pulse was missed - the result is there by now
+        uint32_t now = micros();
+        if (now - selectTime < readTimeout) return;
+        if (alertPin >= 0) {
+            missedReady++;
+        }
+        timeUs = now;
+    }
+
+    AdcReading& reading = readings[current];
+    reading.raw = ads->getLastConversionResults();
+    reading.filtered = filters[current].process(reading.raw);
+    reading.volts = reading.filtered * fullScale(channels[current].gain) / 32768.0f;
+    reading.timeUs = timeUs;
+    reading.count++;
+
+    if (current + 1 >= channelCount) {
+        scanCount++;
+    }
+
+    if (channelCount > 1) {
+        selectChannel((current + 1) % channelCount);
+    } else {
+        selectTime = timeUs;        // Single channel keeps free-running
+    }
+}
+
+void AdcScanController::selectChannel(uint8_t index) {
+    current = index;
+    const AdcChannelConfig& config = channels[current];
+
+    // Writing the config restarts conversion on the new input
+    ads->setGain(config.gain);
+    ads->setDataRate(config.rate);
+    ads->startADCReading(ADS1X15_REG_CONFIG_MUX_SINGLE_0 + config.input * 0x1000, true);
+
+    // A pulse from the previous channel may have landed before the write
+    portENTER_CRITICAL(&mux);
+    readyFlag = false;
+    portEXIT_CRITICAL(&mux);
+
+    selectTime = micros();
+    uint32_t period = conversionTimeUs(config.rate);
+    // Oscillator is +/-10%; with a RDY pin this is only the missed-pulse fallback
+    readTimeout = (alertPin >= 0) ? period * 2 + 2000 : period + period / 5 + 200;
+}
+
+const AdcReading& AdcScanController::getReading(uint8_t channel) {
+    if (channel >= channelCount) channel = 0;
+    return readings[channel];
+}
+
+float AdcScanController::getVolts(uint8_t channel) {
+    if (channel >= channelCount) return 0;
+    return readings[channel].volts;
+}
+
+bool AdcScanController::isFresh(uint8_t channel, unsigned long maxAgeMs) {
+    if (!running || channel >= channelCount || readings[channel].count == 0) return false;
+    return micros() - readings[channel].timeUs <= maxAgeMs * 1000UL;
+}
+
+const char* AdcScanController::getName(uint8_t channel) {
+    if (channel >= channelCount) return "";
+    return channels[channel].name;
+}
+
+SignalFilter* AdcScanController::getFilter(uint8_t channel) {
+    if (channel >= channelCount) return nullptr;
+    return &filters[channel];
+}
+
+uint32_t AdcScanController::conversionTimeUs(uint16_t rate) {
+    return 1000000UL / ADS1115_SPS[(rate >> 5) & 0x07];
+}
+
+float AdcScanController::fullScale(adsGain_t gain) {
+    switch (gain) {
+        case GAIN_TWOTHIRDS: return 6.144f;
+        case GAIN_ONE:       return 4.096f;
+        case GAIN_TWO:       return 2.048f;
+        case GAIN_FOUR:      return 1.024f;
+        case GAIN_EIGHT:     return 0.512f;
+        case GAIN_SIXTEEN:   return 0.256f;
+        default:             return 2.048f;
+    }
+}
+
+void AdcScanController::logStatistics() {
+    if (!running) return;
+    logger.debug("ADC", "Scans", (int)scanCount);
+    if (missedReady > 0) {
+        logger.debug("ADC", "Missed RDY pulses", (int)missedReady);
+    }
+    for (uint8_t i = 0; i < channelCount; i++) {
+        logger.verbose("ADC", channels[i].name, (int)(readings[i].volts * 1000));
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * ADC Scan Controller
+ * ADS1115 multi-channel scan in continuous conversion mode
+ *
+ * The ADC free-runs on the current channel; its ALERT/RDY pin pulses on a
+ * GPIO edge interrupt at the end of every conversion. The ISR only
+ * timestamps the pulse; update() reads the result, filters it and switches
+ * the multiplexer (with that channel's PGA and data rate) to the next
+ * entry of the scan list, which restarts conversion. Nothing waits on a
+ * conversion. Without the RDY pin (or on a missed pulse) the result is
+ * read once the conversion time has passed.
+ */
+
+#ifndef ADCSCANCONTROLLER_H
+#define ADCSCANCONTROLLER_H
+
+#include <Arduino.h>
+#include <Adafruit_ADS1X15.h>
+#include <SignalFilter.h>
+
+// One scan list entry
+struct AdcChannelConfig {
+    const char* name;
+    uint8_t input;                // Single-ended input 0-3
+    adsGain_t gain;               // PGA
+    uint16_t rate;                // RATE_ADS1115_xxSPS
+    SignalFilterConfig filter;    // Applied to the raw counts
+};
+
+// Latest published value of a channel
+struct AdcReading {
+    int16_t raw;                  // Last conversion (counts)
+    int32_t filtered;             // Filter output (counts)
+    float volts;                  // Filtered, in volts at the input
+    uint32_t timeUs;              // micros() at conversion ready
+    uint32_t count;               // Conversions since start
+};
+
+class AdcScanController {
+public:
+    static const uint8_t MAX_CHANNELS = 4;
+
+    AdcScanController();
+
+    // Initialization - alertPin < 0 reads on conversion time only
+    bool init(Adafruit_ADS1115* ads, int8_t alertPin);
+    int8_t addChannel(const AdcChannelConfig& config);    // Scan list index, -1 if full
+
+    // Scanning
+    void start();
+    void stop();
+    void update();
+    bool isRunning() { return running; }
+
+    // Published values
+    const AdcReading& getReading(uint8_t channel);
+    float getVolts(uint8_t channel);
+    bool isFresh(uint8_t channel, unsigned long maxAgeMs);
+    const char* getName(uint8_t channel);
+    uint8_t getChannelCount() { return channelCount; }
+    SignalFilter* getFilter(uint8_t channel);
+
+    // Diagnostics
+    uint32_t getScanCount() { return scanCount; }
+    uint32_t getMissedReady() { return missedReady; }
+    void logStatistics();
+
+private:
+    Adafruit_ADS1115* ads;
+    int8_t alertPin;
+    bool initialized;
+    bool running;
+
+    AdcChannelConfig channels[MAX_CHANNELS];
+    AdcReading readings[MAX_CHANNELS];
+    SignalFilter filters[MAX_CHANNELS];
+    uint8_t channelCount;
+    uint8_t current;
+    uint32_t selectTime;                     // micros() the current conversion was started
+    uint32_t readTimeout;                    // us before reading without a RDY pulse
+
+    uint32_t scanCount;
+    uint32_t missedReady;
+
+    // ISR -> loop
+    volatile bool readyFlag;
+    volatile uint32_t readyTime;
+    portMUX_TYPE mux;
+
+    static AdcScanController* instance;      // Single ADS1115 per machine
+    static void IRAM_ATTR readyISR();
+
+    void selectChannel(uint8_t index);
+    static uint32_t conversionTimeUs(uint16_t rate);
+    static float fullScale(adsGain_t gain);
+};
+
+#endif // ADCSCANCONTROLLER_H
@@ -0,0 +1,200 @@
+/*
+ * Cycle Profiler Implementation
+ */
+
+#include "CycleProfiler.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+// Histogram bucket upper bounds, actual as % of configured
+static const uint16_t BUCKET_LIMITS[PROFILER_BUCKET_COUNT - 1] = {50, 80, 95, 105, 120, 150, 200};
+static const char* const BUCKET_LABELS[PROFILER_BUCKET_COUNT] = {
+    "<50%", "50-80%", "80-95%", "95-105%", "105-120%", "120-150%", "150-200%", ">200%"
+};
+
+CycleProfiler::CycleProfiler() {
+    memset(windowCounts, 0, sizeof(windowCounts));
+    windowIndex = 0;
+    windowSlotStart = 0;
+    windowStart = 0;
+    sumShort = 0;
+    sumLong = 0;
+    idealCycleMs = 0;
+    reset();
+}
+
+void CycleProfiler::reset() {
+    resetPhases();
+    state = PROFILER_STOPPED;
+    stateSince = millis();
+    runMs = 0;
+    downMs = 0;
+    totalTrays = 0;
+    goodTrays = 0;
+}
+
+void CycleProfiler::resetPhases() {
+    memset(phases, 0, sizeof(phases));
+}
+
+void CycleProfiler::recordPhase(uint8_t phase, const char* name, unsigned long actualMs, unsigned long configuredMs) {
+    if (phase >= PROFILER_MAX_PHASES) return;
+
+    PhaseProfile& profile = phases[phase];
+    profile.name = name;
+    profile.configuredMs = configuredMs;
+    if (profile.count == 0 || actualMs < profile.minMs) profile.minMs = actualMs;
+    if (actualMs > profile.maxMs) profile.maxMs = actualMs;
+    profile.totalMs += actualMs;
+    profile.count++;
+
+    // Untimed phases (waits, doses) only keep min/avg/max
+    if (configuredMs > 0) {
+        uint8_t bucket = bucketFor(actualMs, configuredMs);
+        if (profile.buckets[bucket] < 0xFFFF) {
+            profile.buckets[bucket]++;
+        }
+    }
+}
+
+void CycleProfiler::recordTray(bool good) {
+    totalTrays++;
+    if (good) {
+        goodTrays++;
+    }
+
+    advanceWindow();
+    if (windowCounts[windowIndex] < 0xFFFF) {
+        windowCounts[windowIndex]++;
+        sumShort++;
+        sumLong++;
+    }
+}
+
+void CycleProfiler::setState(ProfilerState newState) {
+    if (newState == state) return;
+    accumulateState();
+    state = newState;
+}
+
+uint8_t CycleProfiler::bucketFor(unsigned long actualMs, unsigned long configuredMs) {
+    uint32_t percent = (uint32_t)((uint64_t)actualMs * 100 / configuredMs);
+    for (uint8_t i = 0; i < PROFILER_BUCKET_COUNT - 1; i++) {
+        if (percent < BUCKET_LIMITS[i]) return i;
+    }
+    return PROFILER_BUCKET_COUNT - 1;
+}
+
+void CycleProfiler::accumulateState() {
+    unsigned long now = millis();
+    if (state == PROFILER_RUNNING) {
+        runMs += now - stateSince;
+    } else if (state == PROFILER_DOWN) {
+        downMs += now - stateSince;
+    }
+    stateSince = now;
+}
+
+void CycleProfiler::advanceWindow() {
+    unsigned long now = millis();
+    if (windowStart == 0) {
+        windowStart = now;
+        windowSlotStart = now;
+    }
+    if (now - windowSlotStart < PROFILER_WINDOW_SLOT_MS) return;
+
+    // Idle for longer than the whole window - nothing left in it
+    if (now - windowSlotStart >= PROFILER_WINDOW_SLOT_MS * PROFILER_WINDOW_BUCKETS) {
+        memset(windowCounts, 0, sizeof(windowCounts));
+        sumShort = 0;
+        sumLong = 0;
+        windowSlotStart = now;
+        return;
+    }
+
+    while (now - windowSlotStart >= PROFILER_WINDOW_SLOT_MS) {
+        windowIndex = (windowIndex + 1) % PROFILER_WINDOW_BUCKETS;
+        sumShort -= windowCounts[(windowIndex + PROFILER_WINDOW_BUCKETS - PROFILER_SHORT_BUCKETS) % PROFILER_WINDOW_BUCKETS];
+        sumLong -= windowCounts[windowIndex];
+        windowCounts[windowIndex] = 0;
+        windowSlotStart += PROFILER_WINDOW_SLOT_MS;
+    }
+}
+
+uint16_t CycleProfiler::windowRate(uint32_t sum, uint8_t slots) {
+    if (windowStart == 0) return 0;
+    unsigned long covered = millis() - windowStart;
+    unsigned long span = PROFILER_WINDOW_SLOT_MS * slots;
+    if (covered > span) covered = span;
+    if (covered < 60000UL) return 0;          // Under a minute says nothing
+    return (uint16_t)((uint64_t)sum * 3600000UL / covered);
+}
+
+uint16_t CycleProfiler::getTraysPerHour1h() {
+    advanceWindow();
+    return windowRate(sumShort, PROFILER_SHORT_BUCKETS);
+}
+
+uint16_t CycleProfiler::getTraysPerHour8h() {
+    advanceWindow();
+    return windowRate(sumLong, PROFILER_WINDOW_BUCKETS);
+}
+
+const PhaseProfile* CycleProfiler::getPhase(uint8_t phase) {
+    if (phase >= PROFILER_MAX_PHASES) return nullptr;
+    return &phases[phase];
+}
+
+const char* CycleProfiler::getBucketLabel(uint8_t bucket) {
+    return (bucket < PROFILER_BUCKET_COUNT) ? BUCKET_LABELS[bucket] : "";
+}
+
+uint8_t CycleProfiler::getAvailability() {
+    accumulateState();
+    unsigned long planned = runMs + downMs;
+    if (planned == 0) return 0;
+    return (uint8_t)((uint64_t)runMs * 100 / planned);
+}
+
+uint8_t CycleProfiler::getPerformance() {
+    accumulateState();
+    if (runMs == 0 || idealCycleMs == 0) return 0;
+    uint64_t percent = (uint64_t)idealCycleMs * totalTrays * 100 / runMs;
+    return (percent > 100) ? 100 : (uint8_t)percent;
+}
+
+uint8_t CycleProfiler::getQuality() {
+    if (totalTrays == 0) return 0;
+    return (uint8_t)((uint64_t)goodTrays * 100 / totalTrays);
+}
+
+uint8_t CycleProfiler::getOEE() {
+    return (uint8_t)((uint32_t)getAvailability() * getPerformance() * getQuality() / 10000);
+}
+
+void CycleProfiler::logStatistics() {
+    logger.debug("OEE", "Availability (%)", (int)getAvailability());
+    logger.debug("OEE", "Performance (%)", (int)getPerformance());
+    logger.debug("OEE", "Quality (%)", (int)getQuality());
+    logger.debug("OEE", "OEE (%)", (int)getOEE());
+    logger.debug("OEE", "Trays/hour 1h", (int)getTraysPerHour1h());
+    logger.debug("OEE", "Trays/hour 8h", (int)getTraysPerHour8h());
+
+    for (uint8_t i = 0; i < PROFILER_MAX_PHASES; i++) {
+        const PhaseProfile& profile = phases[i];
+        if (profile.count == 0) continue;
+
+        logger.debug("Phase", profile.name, (unsigned long)(profile.totalMs / profile.count));
+        logger.verbose("Phase", "Min (ms)", (int)profile.minMs);
+        logger.verbose("Phase", "Max (ms)", (int)profile.maxMs);
+        if (profile.configuredMs == 0) continue;
+
+        logger.verbose("Phase", "Configured (ms)", (int)profile.configuredMs);
+        for (uint8_t b = 0; b < PROFILER_BUCKET_COUNT; b++) {
+            if (profile.buckets[b] > 0) {
+                logger.verbose("Phase", BUCKET_LABELS[b], (int)profile.buckets[b]);
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Cycle Profiler
+ * Per-phase cycle-time histograms and OEE counters for production
+ *
+ * Each completed phase records its actual duration against the configured
+ * one into a fixed-bucket histogram of actual/configured. Availability,
+ * performance and quality follow the usual OEE definitions, and trays/hour
+ * is kept over sliding 1 h and 8 h windows of 5-minute buckets.
+ * All storage is static; every record call is constant time.
+ */
+
+#ifndef CYCLEPROFILER_H
+#define CYCLEPROFILER_H
+
+#include <Arduino.h>
+
+#define PROFILER_MAX_PHASES       20
+#define PROFILER_BUCKET_COUNT     8
+#define PROFILER_WINDOW_BUCKETS   96          // 8 h of 5-minute buckets
+#define PROFILER_WINDOW_SLOT_MS   300000UL
+#define PROFILER_SHORT_BUCKETS    12          // 1 h
+
+enum ProfilerState {
+    PROFILER_STOPPED,                         // Not scheduled to produce
+    PROFILER_RUNNING,
+    PROFILER_DOWN                             // Scheduled but paused or faulted
+};
+
+struct PhaseProfile {
+    const char* name;
+    unsigned long configuredMs;               // Last configured duration, 0 = untimed
+    uint32_t count;
+    uint32_t totalMs;
+    uint32_t minMs;
+    uint32_t maxMs;
+    uint16_t buckets[PROFILER_BUCKET_COUNT];  // actual/configured histogram
+};
+
+class CycleProfiler {
+public:
+    CycleProfiler();
+
+    void reset();                             // Clears phases and OEE, keeps the tray windows
+    void resetPhases();                       // Clears the phase histograms only
+
+    // Recording
+    void recordPhase(uint8_t phase, const char* name, unsigned long actualMs, unsigned long configuredMs);
+    void recordTray(bool good);
+    void setState(ProfilerState newState);
+    void setIdealCycleTime(unsigned long ms) { idealCycleMs = ms; }
+
+    // Phases
+    const PhaseProfile* getPhase(uint8_t phase);
+    static const char* getBucketLabel(uint8_t bucket);
+
+    // OEE (percent)
+    uint8_t getAvailability();
+    uint8_t getPerformance();
+    uint8_t getQuality();
+    uint8_t getOEE();
+    uint32_t getTotalTrays() { return totalTrays; }
+    uint32_t getGoodTrays() { return goodTrays; }
+
+    // Sliding windows
+    uint16_t getTraysPerHour1h();
+    uint16_t getTraysPerHour8h();
+
+    void logStatistics();
+
+private:
+    PhaseProfile phases[PROFILER_MAX_PHASES];
+
+    // OEE
+    ProfilerState state;
+    unsigned long stateSince;
+    unsigned long runMs;
+    unsigned long downMs;
+    unsigned long idealCycleMs;
+    uint32_t totalTrays;
+    uint32_t goodTrays;
+
+    // Tray windows
+    uint16_t windowCounts[PROFILER_WINDOW_BUCKETS];
+    uint8_t windowIndex;
+    unsigned long windowSlotStart;
+    unsigned long windowStart;
+    uint32_t sumShort;
+    uint32_t sumLong;
+
+    uint8_t bucketFor(unsigned long actualMs, unsigned long configuredMs);
+    void accumulateState();
+    void advanceWindow();
+    uint16_t windowRate(uint32_t sum, uint8_t slots);
+};
+
+#endif // CYCLEPROFILER_H
@@ -13,6 +13,10 @@ DisplayController::DisplayController() {
     cursorVisible = true;
     lastHealthCheck = 0;
     consecutiveFailures = 0;
+    statusActive = false;
+    statusUntil = 0;
+    pending4Line = false;
+    memset(pendingLines, 0, sizeof(pendingLines));
 }
 
 DisplayController::~DisplayController() {
@@ -55,6 +59,21 @@ void DisplayController::init(uint8_t address, uint8_t cols, uint8_t rows_) {
 void DisplayController::displayText(const char* line1, const char* line2, bool editing) {
     if (!initialized || !lcd) return;
     
+    // Status message on screen - remember the content and draw it when it expires
+    if (statusActive) {
+        currentLine1 = String(line1);
+        currentLine2 = line2 ? String(line2) : "";
+        currentEditMode = editing;
+        pending4Line = false;
+        return;
+    }
+    
+    if (pending4Line) {
+        // Coming back from a 4-line screen - force a full redraw
+        pending4Line = false;
+        currentLine1 = "";
+    }
+    
     String l1 = String(line1);
     String l2 = line2 ? String(line2) : "";
     
@@ -100,6 +119,15 @@ void DisplayController::displayText(String line1, String line2, bool editing) {
 void DisplayController::displayText4Line(const char* line1, const char* line2, const char* line3, const char* line4) {
     if (!initialized || !lcd) return;
     
+    // Keep a copy so a status message can restore this screen
+    snprintf(pendingLines[0], 21, "%s", line1);
+    snprintf(pendingLines[1], 21, "%s", line2);
+    snprintf(pendingLines[2], 21, "%s", line3);
+    snprintf(pendingLines[3], 21, "%s", line4);
+    pending4Line = true;
+    
+    if (statusActive) return;
+    
     // Clear display
     lcd->clear();
     
@@ -140,7 +168,26 @@ void DisplayController::clear() {
 }
 
 void DisplayController::update() {
-    if (!initialized || !lcd || !currentEditMode) return;
+    if (!initialized || !lcd) return;
+    
+    // Restore the screen once a status message expires
+    if (statusActive) {
+        if ((long)(millis() - statusUntil) < 0) return;
+        
+        statusActive = false;
+        if (pending4Line) {
+            displayText4Line(pendingLines[0], pendingLines[1], pendingLines[2], pendingLines[3]);
+        } else {
+            String savedLine1 = currentLine1;
+            String savedLine2 = currentLine2;
+            currentLine1 = "";
+            currentLine2 = "";
+            displayText(savedLine1.c_str(), savedLine2.c_str(), currentEditMode);
+        }
+        return;
+    }
+    
+    if (!currentEditMode) return;
     
     // Blink cursor in edit mode
     unsigned long currentTime = millis();
@@ -190,24 +237,17 @@ void DisplayController::showStartup(const char* title, const char* version) {
 void DisplayController::showStatus(const char* message, unsigned long duration) {
     if (!initialized || !lcd) return;
     
-    // Save current state
-    String savedLine1 = currentLine1;
-    String savedLine2 = currentLine2;
-    bool savedEditMode = currentEditMode;
-    
-    // Show status message
+    // Show status message; update() restores the previous (or newer) content
     lcd->clear();
+    lcd->noCursor();
+    lcd->noBlink();
     lcd->setCursor(0, 0);
     lcd->print("Status:");
     lcd->setCursor(0, 1);
     lcd->print(message);
     
-    delay(duration);
-    
-    // Restore previous display
-    currentLine1 = "";
-    currentLine2 = "";
-    displayText(savedLine1.c_str(), savedLine2.c_str(), savedEditMode);
+    statusActive = true;
+    statusUntil = millis() + duration;
 }
 
 void DisplayController::centerText(char* buffer, const char* text, uint8_t width) {
@@ -23,6 +23,12 @@ private:
     bool cursorVisible;
     static const unsigned long BLINK_INTERVAL = 500; // 500ms blink rate
     
+    // Temporary status message (non-blocking)
+    bool statusActive;
+    unsigned long statusUntil;
+    bool pending4Line;               // Last content requested during status was 4-line
+    char pendingLines[4][21];
+    
     // I2C health monitoring
     unsigned long lastHealthCheck;
     uint8_t consecutiveFailures;
@@ -59,8 +65,9 @@ public:
     // Show startup message
     void showStartup(const char* title, const char* version);
     
-    // Show status message (temporary)
+    // Show status message (temporary, non-blocking - restored by update())
     void showStatus(const char* message, unsigned long duration = 2000);
+    bool isShowingStatus() { return statusActive; }
     
     // Health check and recovery (call in loop)
     void checkHealth();
@@ -0,0 +1,163 @@
+/*
+ * Duty Cycle Scheduler Implementation
+ */
+
+#include "DutyCycleScheduler.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+DutyCycleScheduler::DutyCycleScheduler() {
+    relayControl = nullptr;
+    pendingCheck = nullptr;
+    memset(outputs, 0, sizeof(outputs));
+    outputCount = 0;
+    epoch = 0;
+}
+
+void DutyCycleScheduler::init(void (*relayCallback)(uint8_t relayIndex, bool state)) {
+    relayControl = relayCallback;
+    epoch = millis();
+    logger.info("Duty", "Duty cycle scheduler initialized");
+}
+
+bool DutyCycleScheduler::addOutput(uint8_t relay, unsigned long periodMs, unsigned long minDwellMs) {
+    if (outputCount >= MAX_OUTPUTS || periodMs == 0 || owns(relay)) return false;
+
+    DutyOutput& out = outputs[outputCount++];
+    memset(&out, 0, sizeof(out));
+    out.relay = relay;
+    out.periodMs = periodMs;
+    out.minDwellMs = (minDwellMs * 2 > periodMs) ? periodMs / 2 : minDwellMs;
+    out.duty = 100;
+
+    // Spread the window starts evenly over the outputs
+    for (uint8_t i = 0; i < outputCount; i++) {
+        outputs[i].phaseMs = outputs[i].periodMs * i / outputCount;
+    }
+    return true;
+}
+
+DutyOutput* DutyCycleScheduler::find(uint8_t relay) {
+    for (uint8_t i = 0; i < outputCount; i++) {
+        if (outputs[i].relay == relay) return &outputs[i];
+    }
+    return nullptr;
+}
+
+void DutyCycleScheduler::setDuty(uint8_t relay, int percent) {
+    DutyOutput* out = find(relay);
+    if (out == nullptr) return;
+    // Takes effect from the next window
+    out->duty = constrain(percent, 0, 100);
+}
+
+void DutyCycleScheduler::setActive(uint8_t relay, bool active) {
+    DutyOutput* out = find(relay);
+    if (out == nullptr || out->active == active) return;
+
+    unsigned long now = millis();
+    out->active = active;
+    if (active) {
+        alignWindow(*out, now);
+    } else if (out->on) {
+        switchOutput(*out, false, now);     // Released outputs go off at once
+    }
+}
+
+void DutyCycleScheduler::allOff() {
+    for (uint8_t i = 0; i < outputCount; i++) {
+        setActive(outputs[i].relay, false);
+    }
+}
+
+void DutyCycleScheduler::update() {
+    unsigned long now = millis();
+
+    for (uint8_t i = 0; i < outputCount; i++) {
+        DutyOutput& out = outputs[i];
+        trackLive(out, now);
+        if (!out.active) continue;
+
+        if (now - out.windowStart >= out.periodMs) {
+            out.windowStart += ((now - out.windowStart) / out.periodMs) * out.periodMs;
+            planWindow(out);
+        }
+
+        unsigned long position = now - out.windowStart;
+        bool want = position < out.onTime;
+        if (want == out.on) continue;
+
+        // Minimum dwell - hold the current state, and skip an on span that is already too short
+        // (a full window runs on into the next one)
+        if (now - out.lastSwitch < out.minDwellMs && out.switchCount > 0) continue;
+        if (want && out.onTime < out.periodMs && out.onTime - position < out.minDwellMs) continue;
+        switchOutput(out, want, now);
+    }
+}
+
+// Join the output's window grid part-way through the current window
+void DutyCycleScheduler::alignWindow(DutyOutput& out, unsigned long now) {
+    unsigned long position = (now - epoch + out.periodMs - out.phaseMs) % out.periodMs;
+    out.windowStart = now - position;
+    out.carry = 0;
+    planWindow(out);
+}
+
+void DutyCycleScheduler::planWindow(DutyOutput& out) {
+    long period = (long)out.periodMs;
+    long dwell = (long)out.minDwellMs;
+    long wanted = period * out.duty / 100 + out.carry;
+
+    long span = constrain(wanted, 0L, period);
+    if (span < dwell) {
+        span = 0;
+    } else if (period - span < dwell) {
+        span = period;
+    }
+    out.carry = constrain(wanted - span, -period, period);
+    out.onTime = (unsigned long)span;
+}
+
+void DutyCycleScheduler::switchOutput(DutyOutput& out, bool on, unsigned long now) {
+    if (!on && out.live) {
+        out.onTotal += now - out.onSince;
+    }
+    out.on = on;
+    out.live = false;
+    out.lastSwitch = now;
+    out.switchCount++;
+    if (relayControl) {
+        relayControl(out.relay, on);
+    }
+    trackLive(out, now);
+}
+
+// On time starts once the output has actually switched on
+void DutyCycleScheduler::trackLive(DutyOutput& out, unsigned long now) {
+    if (!out.on || out.live) return;
+    if (pendingCheck && pendingCheck(out.relay)) return;
+    out.live = true;
+    out.onSince = now;
+}
+
+bool DutyCycleScheduler::isOn(uint8_t relay) {
+    DutyOutput* out = find(relay);
+    return out != nullptr && out->on;
+}
+
+unsigned long DutyCycleScheduler::getOnTime(uint8_t relay) {
+    DutyOutput* out = find(relay);
+    if (out == nullptr) return 0;
+    return out->onTotal + (out->live ? millis() - out->onSince : 0);
+}
+
+void DutyCycleScheduler::logStatistics() {
+    for (uint8_t i = 0; i < outputCount; i++) {
+        const DutyOutput& out = outputs[i];
+        if (out.switchCount == 0) continue;
+        logger.verbose("Duty", "Relay", (int)out.relay);
+        logger.verbose("Duty", "Switches", (int)out.switchCount);
+        logger.verbose("Duty", "On time (s)", (int)(getOnTime(out.relay) / 1000));
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Duty Cycle Scheduler
+ * Slow time-proportioning of on/off relay outputs (mixer, conveyor)
+ *
+ * A speed percentage becomes an on/off window: each output has its own
+ * window length and switches on at the start of a window for duty% of it.
+ * On and off spans shorter than the output's minimum dwell are not
+ * switched - the shortfall carries into the next window, so the average
+ * still matches the duty. Window grids are phase-staggered across the
+ * outputs so they do not all switch on the same tick. Outputs are driven
+ * only while active (held by the running step). On time is counted from
+ * when an output actually switched on. Call update() in loop.
+ */
+
+#ifndef DUTYCYCLESCHEDULER_H
+#define DUTYCYCLESCHEDULER_H
+
+#include <Arduino.h>
+
+struct DutyOutput {
+    uint8_t relay;
+    unsigned long periodMs;
+    unsigned long minDwellMs;
+    unsigned long phaseMs;            // Window grid offset
+    uint8_t duty;                     // %
+    bool active;
+    bool on;
+    bool live;                        // Switched on and not waiting on the supply
+    unsigned long windowStart;
+    unsigned long onTime;             // On span of the current window
+    long carry;                       // ms owed to (or by) later windows
+    unsigned long lastSwitch;
+    unsigned long onSince;
+    unsigned long onTotal;            // Switched-on time, closed spans
+    uint32_t switchCount;
+};
+
+class DutyCycleScheduler {
+public:
+    static const uint8_t MAX_OUTPUTS = 8;
+
+    DutyCycleScheduler();
+
+    // Initialization - relayControl switches the outputs (setRelay)
+    void init(void (*relayControl)(uint8_t relayIndex, bool state));
+    // Start of an output still queued (e.g. on the supply budget) - nullptr = switches at once
+    void setPendingCheck(bool (*isPending)(uint8_t relayIndex)) { pendingCheck = isPending; }
+    bool addOutput(uint8_t relay, unsigned long periodMs, unsigned long minDwellMs);
+    bool owns(uint8_t relay) { return find(relay) != nullptr; }
+
+    // Control
+    void setDuty(uint8_t relay, int percent);
+    void setActive(uint8_t relay, bool active);
+    void allOff();
+    void update();
+
+    // Status
+    bool isOn(uint8_t relay);
+    unsigned long getOnTime(uint8_t relay);   // Total switched-on time (ms)
+    void logStatistics();
+
+private:
+    void (*relayControl)(uint8_t relayIndex, bool state);
+    bool (*pendingCheck)(uint8_t relayIndex);
+    DutyOutput outputs[MAX_OUTPUTS];
+    uint8_t outputCount;
+    unsigned long epoch;
+
+    DutyOutput* find(uint8_t relay);
+    void alignWindow(DutyOutput& out, unsigned long now);
+    void planWindow(DutyOutput& out);
+    void switchOutput(DutyOutput& out, bool on, unsigned long now);
+    void trackLive(DutyOutput& out, unsigned long now);
+};
+
+#endif // DUTYCYCLESCHEDULER_H
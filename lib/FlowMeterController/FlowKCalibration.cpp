@@ -0,0 +1,63 @@
+/*
+ * Flow K-Factor Calibration Implementation
+ */
+
+#include "FlowKCalibration.h"
+
+FlowKCalibration::FlowKCalibration() {
+    reset();
+}
+
+void FlowKCalibration::reset() {
+    count = 0;
+    sumX = 0;
+    sumY = 0;
+    sumXX = 0;
+    sumXY = 0;
+    sumYY = 0;
+    minGrams = 0;
+    maxGrams = 0;
+}
+
+void FlowKCalibration::addSample(uint32_t pulses, float grams) {
+    double x = pulses;
+    double y = grams;
+
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+    sumYY += y * y;
+
+    if (count == 0 || grams < minGrams) minGrams = grams;
+    if (count == 0 || grams > maxGrams) maxGrams = grams;
+    if (count < 0xFFFF) count++;
+}
+
+bool FlowKCalibration::solve(FlowKResult& result) {
+    memset(&result, 0, sizeof(result));
+    result.samples = count;
+    if (count < MIN_SAMPLES) return false;
+
+    double n = count;
+    double sxx = sumXX - sumX * sumX / n;
+    double sxy = sumXY - sumX * sumY / n;
+    double syy = sumYY - sumY * sumY / n;
+    if (sxx <= 0) return false;
+
+    double slope = sxy / sxx;                     // grams per pulse
+    if (slope <= 0) return false;
+    double offset = (sumY - slope * sumX) / n;
+
+    // Residual sum of squares straight from the sums - no sample buffer needed
+    double sse = syy - slope * sxy;
+    if (sse < 0) sse = 0;
+    double rms = sqrt(sse / n);
+
+    result.kFactor = (float)(1000.0 * FLOW_CAL_WATER_DENSITY / slope);
+    result.offsetGrams = (float)offset;
+    result.residualGrams = (float)rms;
+    float span = maxGrams - minGrams;
+    result.residualPercent = (span > 0) ? (float)(rms * 100.0 / span) : 0;
+    return true;
+}
@@ -0,0 +1,50 @@
+/*
+ * Flow K-Factor Calibration
+ * Least-squares fit of weighed water mass against flow meter pulses
+ *
+ * mass = slope * pulses + offset; the offset absorbs water in flight
+ * between meter and container and the jet impact on the scale, so the
+ * slope alone gives the K-factor.
+ */
+
+#ifndef FLOWKCALIBRATION_H
+#define FLOWKCALIBRATION_H
+
+#include <Arduino.h>
+
+// Water density used to turn grams into millilitres (20 C)
+#define FLOW_CAL_WATER_DENSITY 0.998f
+
+struct FlowKResult {
+    float kFactor;                // pulses per litre
+    float offsetGrams;            // Fit intercept
+    float residualGrams;          // RMS deviation from the fit
+    float residualPercent;        // RMS deviation relative to the weighed span
+    uint16_t samples;
+};
+
+class FlowKCalibration {
+public:
+    static const uint16_t MIN_SAMPLES = 10;
+
+    FlowKCalibration();
+
+    void reset();
+    void addSample(uint32_t pulses, float grams);
+    uint16_t getSampleCount() { return count; }
+
+    // Returns false if there are too few samples or no pulse spread
+    bool solve(FlowKResult& result);
+
+private:
+    uint16_t count;
+    double sumX;
+    double sumY;
+    double sumXX;
+    double sumXY;
+    double sumYY;
+    float minGrams;
+    float maxGrams;
+};
+
+#endif // FLOWKCALIBRATION_H
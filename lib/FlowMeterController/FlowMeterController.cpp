@@ -0,0 +1,217 @@
+/*
+ * Flow Meter Controller Implementation
+ */
+
+#include "FlowMeterController.h"
+#include <Preferences.h>
+#include <LogController.h>
+
+extern Preferences preferences;
+extern LogController logger;
+
+FlowMeterController::FlowMeterController() {
+    unit = nullptr;
+    channel = nullptr;
+    initialized = false;
+    kFactor = FLOW_DEFAULT_K_FACTOR;
+    lastCount = 0;
+    batchActive = false;
+    batchStartCount = 0;
+    batchEndCount = 0;
+    batchStartTime = 0;
+    lastPulseTime = 0;
+    noFlowTimeout = 0;
+    memset(windowCounts, 0, sizeof(windowCounts));
+    memset(windowTimes, 0, sizeof(windowTimes));
+    windowIndex = 0;
+    windowCount = 0;
+    lastSnapshot = 0;
+    flowRate = 0;
+}
+
+bool FlowMeterController::init(uint8_t pin) {
+    logger.info("Flow", "Initializing PCNT flow meter...");
+
+    // Count up only; the accumulator extends the 16-bit hardware counter
+    pcnt_unit_config_t unitConfig = {};
+    unitConfig.low_limit = -1;
+    unitConfig.high_limit = PCNT_HIGH_LIMIT;
+    unitConfig.flags.accum_count = 1;
+    if (pcnt_new_unit(&unitConfig, &unit) != ESP_OK) {
+        logger.error("Flow", "PCNT unit allocation failed!");
+        return false;
+    }
+
+    pcnt_glitch_filter_config_t filterConfig = {};
+    filterConfig.max_glitch_ns = GLITCH_FILTER_NS;
+    pcnt_unit_set_glitch_filter(unit, &filterConfig);
+
+    pcnt_chan_config_t chanConfig = {};
+    chanConfig.edge_gpio_num = pin;
+    chanConfig.level_gpio_num = -1;
+    if (pcnt_new_channel(unit, &chanConfig, &channel) != ESP_OK) {
+        logger.error("Flow", "PCNT channel allocation failed!");
+        return false;
+    }
+
+    // Rising edge counts, falling edge ignored
+    pcnt_channel_set_edge_action(channel, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD);
+
+    // Overflow at the high limit is folded into the accumulated count
+    pcnt_unit_add_watch_point(unit, PCNT_HIGH_LIMIT);
+
+    pcnt_unit_enable(unit);
+    pcnt_unit_clear_count(unit);
+    pcnt_unit_start(unit);
+
+    initialized = true;
+    loadKFactor();
+
+    logger.info("Flow", "K-factor (pulses/L)", (int)kFactor);
+    return true;
+}
+
+int32_t FlowMeterController::readCount() {
+    int count = 0;
+    pcnt_unit_get_count(unit, &count);
+    return count;
+}
+
+void FlowMeterController::update() {
+    if (!initialized) return;
+
+    unsigned long now = millis();
+    int32_t count = readCount();
+
+    if (count != lastCount) {
+        lastPulseTime = now;
+        lastCount = count;
+    }
+
+    updateFlowRate(count, now);
+}
+
+void FlowMeterController::updateFlowRate(int32_t count, unsigned long now) {
+    // Flow stopped - clear the window so the next start is measured fresh
+    if (now - lastPulseTime >= FLOW_STOP_TIME) {
+        flowRate = 0;
+        windowCount = 0;
+        return;
+    }
+
+    // Snapshot only when new pulses arrived, so each timestamp marks a pulse
+    uint8_t newest = (windowIndex + WINDOW_SIZE - 1) % WINDOW_SIZE;
+    bool changed = (windowCount == 0) || (count != windowCounts[newest]);
+    if (changed && now - lastSnapshot >= SNAPSHOT_INTERVAL) {
+        windowCounts[windowIndex] = count;
+        windowTimes[windowIndex] = now;
+        windowIndex = (windowIndex + 1) % WINDOW_SIZE;
+        if (windowCount < WINDOW_SIZE) windowCount++;
+        lastSnapshot = now;
+        newest = (windowIndex + WINDOW_SIZE - 1) % WINDOW_SIZE;
+    }
+
+    if (windowCount < 2) {
+        flowRate = 0;
+        return;
+    }
+
+    // Oldest snapshot still inside the rate window
+    uint8_t oldest = newest;
+    for (uint8_t i = 1; i < windowCount; i++) {
+        uint8_t idx = (newest + WINDOW_SIZE - i) % WINDOW_SIZE;
+        if (windowTimes[newest] - windowTimes[idx] > RATE_WINDOW) break;
+        oldest = idx;
+    }
+
+    unsigned long span = windowTimes[newest] - windowTimes[oldest];
+    int32_t pulses = windowCounts[newest] - windowCounts[oldest];
+    if (span == 0 || pulses <= 0) {
+        flowRate = 0;
+        return;
+    }
+
+    // Pulse-to-pulse rate, pulled down if no pulse arrived since the last snapshot
+    unsigned long elapsed = now - windowTimes[oldest];
+    if (elapsed > span + SNAPSHOT_INTERVAL) {
+        span = elapsed;
+    }
+    flowRate = pulsesToMl(pulses) * 1000.0f / span;
+}
+
+float FlowMeterController::pulsesToMl(int32_t pulses) {
+    if (kFactor <= 0) return 0.0;
+    return pulses * 1000.0f / kFactor;
+}
+
+void FlowMeterController::startBatch() {
+    batchStartCount = initialized ? readCount() : 0;
+    batchEndCount = batchStartCount;
+    batchStartTime = millis();
+    lastPulseTime = batchStartTime;   // Timeout counts from the batch start
+    batchActive = true;
+    logger.debug("Flow", "Batch started");
+}
+
+void FlowMeterController::stopBatch() {
+    if (!batchActive) return;
+
+    batchEndCount = initialized ? readCount() : batchStartCount;
+    batchActive = false;
+    logger.info("Flow", "Batch volume (ml)", (int)getBatchVolumeMl());
+}
+
+uint32_t FlowMeterController::getBatchPulses() {
+    int32_t end = batchActive ? lastCount : batchEndCount;
+    return (end > batchStartCount) ? (uint32_t)(end - batchStartCount) : 0;
+}
+
+float FlowMeterController::getBatchVolumeMl() {
+    return pulsesToMl(getBatchPulses());
+}
+
+float FlowMeterController::getTotalVolumeL() {
+    return pulsesToMl(lastCount) / 1000.0f;
+}
+
+bool FlowMeterController::isNoFlowTimeout() {
+    if (!batchActive || noFlowTimeout == 0) return false;
+    return getTimeSinceLastPulse() >= noFlowTimeout;
+}
+
+unsigned long FlowMeterController::getTimeSinceLastPulse() {
+    return millis() - lastPulseTime;
+}
+
+void FlowMeterController::setKFactor(float pulsesPerLitre) {
+    if (isnan(pulsesPerLitre) || pulsesPerLitre <= 0) {
+        logger.warning("Flow", "Invalid K-factor ignored");
+        return;
+    }
+    kFactor = pulsesPerLitre;
+}
+
+void FlowMeterController::saveKFactor() {
+    preferences.putFloat("flowK", kFactor);
+    logger.info("Flow", "K-factor saved");
+}
+
+void FlowMeterController::loadKFactor() {
+    float value = preferences.getFloat("flowK", FLOW_DEFAULT_K_FACTOR);
+    if (isnan(value) || value <= 0) {
+        logger.warning("Flow", "Invalid K-factor, using default");
+        value = FLOW_DEFAULT_K_FACTOR;
+    }
+    kFactor = value;
+}
+
+void FlowMeterController::logStatistics() {
+    if (!initialized) return;
+
+    logger.debug("Flow", "Pulse count", (int)lastCount);
+    logger.debug("Flow", "Flow rate (ml/s)", (int)flowRate);
+    logger.debug("Flow", "Total volume (L)", (int)getTotalVolumeL());
+    if (batchActive) {
+        logger.debug("Flow", "Batch volume (ml)", (int)getBatchVolumeMl());
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Flow Meter Controller
+ * Hall-effect water flow sensor counted by the ESP32 PCNT peripheral
+ *
+ * Pulses are counted in hardware (with glitch filter), the loop only reads
+ * the counter. Provides a batch totalizer, flow rate and no-flow timeout.
+ */
+
+#ifndef FLOWMETERCONTROLLER_H
+#define FLOWMETERCONTROLLER_H
+
+#include <Arduino.h>
+#include <driver/pulse_cnt.h>
+
+// Default K-factor for YF-S201 style sensors (pulses per litre)
+#define FLOW_DEFAULT_K_FACTOR 450.0f
+
+class FlowMeterController {
+public:
+    static const uint8_t WINDOW_SIZE = 8;            // Timestamped pulse snapshots kept for the rate
+
+    FlowMeterController();
+
+    // Initialization
+    bool init(uint8_t pin);
+
+    // Poll the counter (call in loop)
+    void update();
+
+    // Batch totalizer
+    void startBatch();
+    void stopBatch();
+    bool isBatchActive() { return batchActive; }
+    uint32_t getBatchPulses();
+    float getBatchVolumeMl();
+    float getTotalVolumeL();                          // Since power-up
+
+    // Instantaneous flow rate
+    float getFlowRateMlPerSec() { return flowRate; }
+    bool isFlowing() { return flowRate > 0; }
+
+    // No-flow timeout (only armed while a batch is active)
+    void setNoFlowTimeout(unsigned long timeoutMs) { noFlowTimeout = timeoutMs; }
+    bool isNoFlowTimeout();
+    unsigned long getTimeSinceLastPulse();
+
+    // K-factor (pulses per litre), stored in Preferences
+    void setKFactor(float pulsesPerLitre);
+    float getKFactor() { return kFactor; }
+    void saveKFactor();
+    void loadKFactor();
+
+    // Status
+    bool isConnected() { return initialized; }
+    int32_t getPulseCount() { return lastCount; }
+    void logStatistics();
+
+private:
+    pcnt_unit_handle_t unit;
+    pcnt_channel_handle_t channel;
+    bool initialized;
+
+    float kFactor;
+    int32_t lastCount;
+
+    // Batch state
+    bool batchActive;
+    int32_t batchStartCount;
+    int32_t batchEndCount;
+    unsigned long batchStartTime;
+    unsigned long lastPulseTime;
+    unsigned long noFlowTimeout;
+
+    // Flow rate - counter snapshots taken when the count changed
+    int32_t windowCounts[WINDOW_SIZE];
+    unsigned long windowTimes[WINDOW_SIZE];
+    uint8_t windowIndex;
+    uint8_t windowCount;
+    unsigned long lastSnapshot;
+    float flowRate;                                   // ml/s
+
+    static const int PCNT_HIGH_LIMIT = 30000;         // Hardware counter wraps into the accumulator here
+    static const uint32_t GLITCH_FILTER_NS = 10000;   // Ignore pulses shorter than 10 us
+    static const unsigned long SNAPSHOT_INTERVAL = 100;   // ms between rate snapshots
+    static const unsigned long RATE_WINDOW = 1000;        // ms span used for the rate
+    static const unsigned long FLOW_STOP_TIME = 2000;     // no pulse for this long = 0 ml/s
+
+    int32_t readCount();
+    void updateFlowRate(int32_t count, unsigned long now);
+    float pulsesToMl(int32_t pulses);
+};
+
+#endif // FLOWMETERCONTROLLER_H
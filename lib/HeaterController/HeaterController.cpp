@@ -0,0 +1,469 @@
+/*
+ * Heater Controller Implementation
+ */
+
+#include "HeaterController.h"
+#include <Preferences.h>
+#include <LogController.h>
+
+extern Preferences preferences;
+extern LogController logger;
+
+HeaterController::HeaterController() {
+    adc = nullptr;
+    channel = 0;
+    heaterRelay = 0;
+    relayControl = nullptr;
+    pendingCheck = nullptr;
+    state = HEATER_OFF;
+    setpoint = 0;
+    temperature = 0;
+    sensorOk = false;
+    lastSample = 0;
+    sensorErrors = 0;
+    kp = DEFAULT_KP;
+    ki = DEFAULT_KI;
+    kd = DEFAULT_KD;
+    integral = 0;
+    lastInput = 0;
+    duty = 0;
+    pidPrimed = false;
+    relayOn = false;
+    relayChangeTime = 0;
+    windowStart = 0;
+    windowOnTime = 0;
+    dutyCarry = 0;
+    heatRate = DEFAULT_HEAT_RATE;
+    lossRate = 0;
+    ambient = 0;
+    heatSamples = 0;
+    lossSamples = 0;
+    modelStart = 0;
+    modelStartTemp = 0;
+    modelCount = 0;
+    modelOnCount = 0;
+    savedHeatRate = 0;
+    savedLossRate = 0;
+    tuneHigh = false;
+    tuneStart = 0;
+    tuneLastRise = 0;
+    tuneMax = 0;
+    tuneMin = 0;
+    tuneCycles = 0;
+    tuneAmplitudeSum = 0;
+    tunePeriodSum = 0;
+}
+
+void HeaterController::init(AdcScanController* scanner, uint8_t adcChannel, uint8_t relay,
+                            void (*relayCallback)(uint8_t relayIndex, bool state)) {
+    adc = scanner;
+    channel = adcChannel;
+    heaterRelay = relay;
+    relayControl = relayCallback;
+
+    loadGains();
+    relayOff();
+
+    // Learned thermal model from the last run
+    heatRate = preferences.getFloat("htrRate", 0);
+    lossRate = preferences.getFloat("htrLoss", 0);
+    if (isnan(heatRate) || heatRate <= 0) {
+        heatRate = DEFAULT_HEAT_RATE;
+    } else {
+        heatSamples = 1;
+    }
+    if (isnan(lossRate) || lossRate <= 0) {
+        lossRate = 0;
+    } else {
+        lossSamples = 1;
+    }
+    savedHeatRate = heatRate;
+    savedLossRate = lossRate;
+
+    if (adc == nullptr || !adc->isRunning()) {
+        logger.error("Heater", "No temperature input - heater disabled");
+        return;
+    }
+    logger.info("Heater", "Heater controller initialized");
+}
+
+void HeaterController::setEnabled(bool enabled) {
+    if (enabled) {
+        if (state == HEATER_PID || state == HEATER_FAULT) return;
+        if (!sensorOk) {
+            enterFault("Temperature sensor fault");
+            return;
+        }
+        relayOff();             // Outputs may have been switched off behind our back
+        state = HEATER_PID;
+        pidPrimed = false;
+        dutyCarry = 0;
+        windowOnTime = 0;
+        logger.debug("Heater", "PID on, setpoint (C)", (int)setpoint);
+        return;
+    }
+
+    if (state == HEATER_PID) {
+        state = HEATER_OFF;
+        duty = 0;
+        relayOff();
+        saveModel();
+    }
+}
+
+void HeaterController::clearFault() {
+    if (state != HEATER_FAULT) return;
+    state = HEATER_OFF;
+    logger.info("Heater", "Fault cleared");
+}
+
+void HeaterController::update() {
+    if (adc == nullptr) return;
+
+    unsigned long now = millis();
+    if (now - lastSample >= SAMPLE_INTERVAL) {
+        lastSample = now;
+        sample();
+    }
+
+    updateOutput();
+}
+
+void HeaterController::sample() {
+    float celsius;
+    if (!readTemperature(celsius)) {
+        if (sensorErrors < MAX_SENSOR_ERRORS) {
+            sensorErrors++;
+        }
+        if (sensorErrors >= MAX_SENSOR_ERRORS && sensorOk) {
+            sensorOk = false;
+            if (state == HEATER_PID || state == HEATER_AUTOTUNE) {
+                enterFault("Temperature sensor fault");
+            }
+        }
+        return;
+    }
+
+    // Already filtered by the ADC scan
+    if (!sensorOk && modelStart == 0) {
+        ambient = celsius;
+    }
+    temperature = celsius;
+    sensorErrors = 0;
+    sensorOk = true;
+    learnModel();
+
+    if (state != HEATER_PID && state != HEATER_AUTOTUNE) return;
+
+    if (temperature > MAX_TEMPERATURE || temperature > setpoint + OVER_TEMP_MARGIN) {
+        enterFault("Over-temperature");
+        return;
+    }
+
+    if (state == HEATER_PID) {
+        runPid(SAMPLE_INTERVAL / 1000.0f);
+    } else {
+        runAutoTune();
+    }
+}
+
+bool HeaterController::readTemperature(float& celsius) {
+    if (!adc->isFresh(channel, SAMPLE_INTERVAL * 2)) return false;
+    float volts = adc->getVolts(channel);
+
+    // Open or shorted thermistor
+    if (volts < 0.02f || volts > SUPPLY_VOLTAGE - 0.02f) return false;
+
+    float resistance = SERIES_RESISTOR * volts / (SUPPLY_VOLTAGE - volts);
+    celsius = 1.0f / (1.0f / 298.15f + log(resistance / NTC_R25) / NTC_BETA) - 273.15f;
+    return true;
+}
+
+// One estimate per window: cooling with the relay off gives the loss rate,
+// heating with mostly full power gives the heat-up rate net of losses.
+// Ambient is the coldest reading seen - the dryer cools to it when idle.
+void HeaterController::learnModel() {
+    unsigned long now = millis();
+    if (temperature < ambient) ambient = temperature;
+
+    if (modelStart == 0) {
+        modelStart = now;
+        modelStartTemp = temperature;
+        modelCount = 0;
+        modelOnCount = 0;
+    }
+    modelCount++;
+    if (isRelayLive()) modelOnCount++;
+
+    if (now - modelStart < MODEL_WINDOW) return;
+
+    float seconds = (now - modelStart) / 1000.0f;
+    float slope = (temperature - modelStartTemp) / seconds;
+    float power = (float)modelOnCount / modelCount;
+    float excess = (temperature + modelStartTemp) / 2.0f - ambient;
+
+    if (modelOnCount == 0 && excess > MIN_LOSS_EXCESS && slope < 0) {
+        float estimate = -slope / excess;
+        lossRate = (lossSamples == 0) ? estimate : lossRate + (estimate - lossRate) * MODEL_SMOOTHING;
+        if (lossSamples < 0xFFFF) lossSamples++;
+    } else if (power > 0.5f) {
+        float estimate = (slope + lossRate * excess) / power;
+        if (estimate > 0) {
+            heatRate = (heatSamples == 0) ? estimate : heatRate + (estimate - heatRate) * MODEL_SMOOTHING;
+            if (heatSamples < 0xFFFF) heatSamples++;
+        }
+    }
+
+    modelStart = now;
+    modelStartTemp = temperature;
+    modelCount = 0;
+    modelOnCount = 0;
+}
+
+unsigned long HeaterController::getHeatUpTime(float celsius) {
+    if (!sensorOk) return HEAT_UP_UNKNOWN;
+    if (temperature >= celsius) return 0;
+
+    // No measured losses yet - straight line at the heat-up rate
+    if (lossRate <= 0) {
+        return (unsigned long)((celsius - temperature) / heatRate * 1000.0f);
+    }
+
+    // First order: T(t) = Tss - (Tss - T0) e^(-loss t)
+    float steadyState = ambient + heatRate / lossRate;
+    if (steadyState <= celsius) return HEAT_UP_UNKNOWN;
+    float seconds = log((steadyState - temperature) / (steadyState - celsius)) / lossRate;
+    return (unsigned long)(seconds * 1000.0f);
+}
+
+void HeaterController::runPid(float dt) {
+    float error = setpoint - temperature;
+
+    if (!pidPrimed) {
+        lastInput = temperature;
+    }
+
+    // Derivative on measurement - no kick when the setpoint changes
+    float proportional = kp * error;
+    float derivative = -kd * (temperature - lastInput) / dt;
+    lastInput = temperature;
+
+    // Anti-windup: only integrate when it does not push further into saturation
+    float candidate = integral + ki * error * dt;
+    float output = proportional + candidate + derivative;
+    if ((output > 100.0f && error > 0) || (output < 0 && error < 0)) {
+        output = proportional + integral + derivative;
+    } else {
+        integral = candidate;
+    }
+    integral = constrain(integral, 0.0f, 100.0f);
+    duty = constrain(output, 0.0f, 100.0f);
+
+    if (!pidPrimed) {
+        // First output is known - start a window with it right away
+        pidPrimed = true;
+        windowStart = millis() - WINDOW_TIME;
+    }
+}
+
+void HeaterController::updateOutput() {
+    if (state == HEATER_AUTOTUNE) {
+        // Bang-bang switching still honours the relay minimums
+        unsigned long minTime = relayOn ? MIN_ON_TIME : MIN_OFF_TIME;
+        if (tuneHigh != relayOn && millis() - relayChangeTime >= minTime) {
+            setRelay(tuneHigh);
+        }
+        return;
+    }
+    if (state != HEATER_PID || !pidPrimed) {
+        setRelay(false);
+        return;
+    }
+
+    unsigned long now = millis();
+    if (now - windowStart >= WINDOW_TIME) {
+        // Periods too short for the relay are carried into the next window
+        long onTime = (long)(duty * WINDOW_TIME / 100.0f) + dutyCarry;
+        if (onTime < (long)MIN_ON_TIME) {
+            dutyCarry = onTime;
+            onTime = 0;
+        } else if ((long)WINDOW_TIME - onTime < (long)MIN_OFF_TIME) {
+            dutyCarry = onTime - (long)WINDOW_TIME;
+            onTime = WINDOW_TIME;
+        } else {
+            dutyCarry = 0;
+        }
+        dutyCarry = constrain(dutyCarry, -(long)WINDOW_TIME, (long)WINDOW_TIME);
+        windowOnTime = onTime;
+        windowStart = now;
+    }
+
+    // The window only starts once the relay has actually switched on - a
+    // start queued on the supply budget must not eat into the on time
+    if (relayOn && !isRelayLive()) {
+        windowStart = now;
+    }
+
+    setRelay(now - windowStart < windowOnTime);
+}
+
+bool HeaterController::startAutoTune(float celsius) {
+    if (adc == nullptr || !sensorOk) {
+        logger.error("Heater", "Auto-tune needs the temperature sensor");
+        return false;
+    }
+
+    setpoint = celsius;
+    tuneHigh = temperature < setpoint;
+    tuneStart = millis();
+    tuneLastRise = 0;
+    tuneMax = temperature;
+    tuneMin = temperature;
+    tuneCycles = 0;
+    tuneAmplitudeSum = 0;
+    tunePeriodSum = 0;
+    state = HEATER_AUTOTUNE;
+    logger.info("Heater", "Auto-tune started (C)", (int)setpoint);
+    return true;
+}
+
+void HeaterController::cancelAutoTune() {
+    if (state != HEATER_AUTOTUNE) return;
+    state = HEATER_OFF;
+    duty = 0;
+    relayOff();
+    logger.warning("Heater", "Auto-tune cancelled");
+}
+
+// Relay (bang-bang) experiment: the oscillation it forces gives the
+// ultimate gain Ku = 4d / (pi a) and period Pu for Ziegler-Nichols gains
+void HeaterController::runAutoTune() {
+    unsigned long now = millis();
+    if (now - tuneStart > AUTOTUNE_TIMEOUT) {
+        logger.error("Heater", "Auto-tune timed out");
+        cancelAutoTune();
+        return;
+    }
+
+    if (temperature > tuneMax) tuneMax = temperature;
+    if (temperature < tuneMin) tuneMin = temperature;
+
+    if (tuneHigh && temperature > setpoint + AUTOTUNE_HYSTERESIS) {
+        tuneHigh = false;
+    } else if (!tuneHigh && temperature < setpoint - AUTOTUNE_HYSTERESIS) {
+        tuneHigh = true;
+
+        // One full oscillation since the previous switch-on
+        if (tuneLastRise != 0) {
+            tuneAmplitudeSum += (tuneMax - tuneMin) / 2.0f;
+            tunePeriodSum += now - tuneLastRise;
+            tuneCycles++;
+            logger.debug("Heater", "Auto-tune cycle", (int)tuneCycles);
+        }
+        tuneLastRise = now;
+        tuneMax = temperature;
+        tuneMin = temperature;
+    }
+    duty = tuneHigh ? 100.0f : 0;
+
+    if (tuneCycles < AUTOTUNE_CYCLES) return;
+
+    float amplitude = tuneAmplitudeSum / tuneCycles;
+    float period = tunePeriodSum / (float)tuneCycles / 1000.0f;
+    state = HEATER_OFF;
+    duty = 0;
+    relayOff();
+
+    if (amplitude <= 0 || period <= 0) {
+        logger.error("Heater", "Auto-tune failed");
+        return;
+    }
+
+    float ku = 4.0f * 50.0f / (PI * amplitude);
+    setGains(0.6f * ku, 1.2f * ku / period, 0.075f * ku * period);
+    saveGains();
+    logger.info("Heater", "Auto-tune period (s)", (int)period);
+}
+
+bool HeaterController::isAtSetpoint(float band) {
+    return sensorOk && fabs(temperature - setpoint) <= band;
+}
+
+void HeaterController::setGains(float p, float i, float d) {
+    kp = p;
+    ki = i;
+    kd = d;
+    integral = 0;
+}
+
+void HeaterController::loadGains() {
+    kp = preferences.getFloat("htrKp", DEFAULT_KP);
+    ki = preferences.getFloat("htrKi", DEFAULT_KI);
+    kd = preferences.getFloat("htrKd", DEFAULT_KD);
+    if (isnan(kp) || kp <= 0) kp = DEFAULT_KP;
+    if (isnan(ki) || ki < 0) ki = DEFAULT_KI;
+    if (isnan(kd) || kd < 0) kd = DEFAULT_KD;
+}
+
+void HeaterController::saveGains() {
+    preferences.putFloat("htrKp", kp);
+    preferences.putFloat("htrKi", ki);
+    preferences.putFloat("htrKd", kd);
+    logger.debug("Heater", "PID gains saved");
+}
+
+void HeaterController::saveModel() {
+    // Skip flash writes for small drift
+    if (fabs(heatRate - savedHeatRate) < savedHeatRate * 0.1f &&
+        fabs(lossRate - savedLossRate) < savedLossRate * 0.1f + 1e-6f) return;
+
+    preferences.putFloat("htrRate", heatRate);
+    preferences.putFloat("htrLoss", lossRate);
+    savedHeatRate = heatRate;
+    savedLossRate = lossRate;
+    logger.debug("Heater", "Thermal model saved");
+}
+
+void HeaterController::setRelay(bool on) {
+    if (on == relayOn) return;
+    relayOn = on;
+    relayChangeTime = millis();
+    if (relayControl) {
+        relayControl(heaterRelay, on);
+    }
+}
+
+bool HeaterController::isRelayLive() {
+    return relayOn && (pendingCheck == nullptr || !pendingCheck(heaterRelay));
+}
+
+void HeaterController::relayOff() {
+    if (relayOn) {
+        relayChangeTime = millis();
+    }
+    relayOn = false;
+    if (relayControl) {
+        relayControl(heaterRelay, false);
+    }
+}
+
+void HeaterController::enterFault(const char* reason) {
+    state = HEATER_FAULT;
+    duty = 0;
+    relayOff();
+    logger.error("Heater", reason);
+}
+
+void HeaterController::logStatistics() {
+    if (!sensorOk) return;
+    logger.debug("Heater", "Temperature (C)", (int)temperature);
+    logger.verbose("Heater", "Heat rate (mC/s)", (int)(heatRate * 1000));
+    logger.verbose("Heater", "Loss rate (1/ks)", (int)(lossRate * 1000));
+    logger.verbose("Heater", "Ambient (C)", (int)ambient);
+    if (state == HEATER_OFF) return;
+    logger.debug("Heater", "Setpoint (C)", (int)setpoint);
+    logger.debug("Heater", "Duty (%)", (int)duty);
+    logger.verbose("Heater", "Kp x100", (int)(kp * 100));
+    logger.verbose("Heater", "Ki x1000", (int)(ki * 1000));
+    logger.verbose("Heater", "Kd x100", (int)(kd * 100));
+}
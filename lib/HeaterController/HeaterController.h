@@ -0,0 +1,169 @@
+/*
+ * Heater Controller
+ * PID temperature control of the drying heater
+ *
+ * An NTC thermistor divider is read from one channel of the ADS1115 scan
+ * (filtered, never blocks). A PID loop with derivative on measurement and
+ * conditional-integration anti-windup sets a 0-100% duty, which drives the
+ * heater relay time-proportioned over a fixed window. On and off periods
+ * shorter than the relay minimum are carried into the next window so the
+ * average duty is kept without chattering the contacts.
+ * Relay auto-tune (Astrom-Hagglund) finds the gains; they are stored in
+ * Preferences. A first-order thermal model (heat-up rate at full power,
+ * loss towards ambient) is learned from the same temperature stream and
+ * predicts how long a heat-up will take. Call update() in loop.
+ */
+
+#ifndef HEATERCONTROLLER_H
+#define HEATERCONTROLLER_H
+
+#include <Arduino.h>
+#include <AdcScanController.h>
+
+enum HeaterState {
+    HEATER_OFF,
+    HEATER_PID,
+    HEATER_AUTOTUNE,
+    HEATER_FAULT              // Sensor or over-temperature - relay held off until cleared
+};
+
+#define HEAT_UP_UNKNOWN 0xFFFFFFFFUL
+
+class HeaterController {
+public:
+    HeaterController();
+
+    // Initialization - channel is the scan list index of the thermistor
+    void init(AdcScanController* adc, uint8_t channel, uint8_t heaterRelay,
+              void (*relayControl)(uint8_t relayIndex, bool state));
+    // Switch-on still queued (e.g. on the supply budget) - nullptr = switches at once
+    void setPendingCheck(bool (*isPending)(uint8_t relayIndex)) { pendingCheck = isPending; }
+
+    // Control
+    void setSetpoint(float celsius) { setpoint = celsius; }
+    void setEnabled(bool enabled);            // Cannot re-arm a fault
+    void clearFault();                        // Operator acknowledge - back to off
+    void update();
+
+    // Auto-tune around the setpoint (replaces the gains when it completes)
+    bool startAutoTune(float celsius);
+    void cancelAutoTune();
+    bool isAutoTuning() { return state == HEATER_AUTOTUNE; }
+
+    // Status
+    HeaterState getState() { return state; }
+    bool isEnabled() { return state == HEATER_PID; }
+    bool isFault() { return state == HEATER_FAULT; }
+    bool isSensorOk() { return sensorOk; }
+    float getTemperature() { return temperature; }
+    float getSetpoint() { return setpoint; }
+    float getDuty() { return duty; }                  // %
+    bool isAtSetpoint(float band);
+    bool isRelayOn() { return relayOn; }
+
+    // Thermal model - dT/dt = heatRate * power - lossRate * (T - ambient)
+    unsigned long getHeatUpTime(float celsius);       // ms at full power, HEAT_UP_UNKNOWN if unreachable
+    float getHeatRate() { return heatRate; }          // C/s at full power
+    float getLossRate() { return lossRate; }          // 1/s
+    float getAmbient() { return ambient; }
+    bool isModelLearned() { return heatSamples > 0 && lossSamples > 0; }
+    void saveModel();                                 // Only writes when the model moved
+
+    // Gains (stored in Preferences)
+    float getKp() { return kp; }
+    float getKi() { return ki; }
+    float getKd() { return kd; }
+    void setGains(float p, float i, float d);
+    void loadGains();
+    void saveGains();
+
+    void logStatistics();
+
+private:
+    AdcScanController* adc;
+    uint8_t channel;
+    uint8_t heaterRelay;
+    void (*relayControl)(uint8_t relayIndex, bool state);
+    bool (*pendingCheck)(uint8_t relayIndex);
+
+    HeaterState state;
+    float setpoint;
+    float temperature;
+    bool sensorOk;
+    unsigned long lastSample;
+    uint8_t sensorErrors;
+
+    // PID
+    float kp;
+    float ki;
+    float kd;
+    float integral;
+    float lastInput;
+    float duty;
+    bool pidPrimed;
+
+    // Time-proportioned output
+    bool relayOn;
+    unsigned long relayChangeTime;                    // Last switch, for the minimum on/off times
+    unsigned long windowStart;
+    unsigned long windowOnTime;
+    long dutyCarry;                                   // ms owed to (or by) the next window
+
+    // Thermal model
+    float heatRate;
+    float lossRate;
+    float ambient;
+    uint16_t heatSamples;
+    uint16_t lossSamples;
+    unsigned long modelStart;
+    float modelStartTemp;
+    uint16_t modelCount;
+    uint16_t modelOnCount;
+    float savedHeatRate;
+    float savedLossRate;
+
+    // Auto-tune
+    bool tuneHigh;
+    unsigned long tuneStart;
+    unsigned long tuneLastRise;
+    float tuneMax;
+    float tuneMin;
+    uint8_t tuneCycles;
+    float tuneAmplitudeSum;
+    unsigned long tunePeriodSum;
+
+    static const unsigned long SAMPLE_INTERVAL = 500;     // ms - PID period
+    static const unsigned long WINDOW_TIME = 10000;       // ms - time-proportioning window
+    static const unsigned long MIN_ON_TIME = 2000;        // ms - relay contact life
+    static const unsigned long MIN_OFF_TIME = 2000;
+    static const unsigned long AUTOTUNE_TIMEOUT = 1800000UL;  // 30 min
+    static const uint8_t AUTOTUNE_CYCLES = 3;             // Measured after the first
+    static const uint8_t MAX_SENSOR_ERRORS = 3;
+    static constexpr float MAX_TEMPERATURE = 150.0f;      // Hard cut-off
+    static constexpr float OVER_TEMP_MARGIN = 25.0f;      // Above setpoint
+    static constexpr float AUTOTUNE_HYSTERESIS = 0.5f;    // C
+    static constexpr float SERIES_RESISTOR = 10000.0f;    // Divider resistor to the 3.3 V rail
+    static constexpr float SUPPLY_VOLTAGE = 3.3f;
+    static constexpr float NTC_R25 = 10000.0f;
+    static constexpr float NTC_BETA = 3950.0f;
+    static constexpr float DEFAULT_KP = 5.0f;             // % per C
+    static constexpr float DEFAULT_KI = 0.05f;            // % per C.s
+    static constexpr float DEFAULT_KD = 20.0f;            // % s per C
+    static const unsigned long MODEL_WINDOW = 20000;      // ms per model estimate
+    static constexpr float DEFAULT_HEAT_RATE = 0.05f;     // C/s until learned
+    static constexpr float MIN_LOSS_EXCESS = 5.0f;        // C above ambient to measure losses
+    static constexpr float MODEL_SMOOTHING = 0.2f;
+
+    void sample();
+    bool readTemperature(float& celsius);
+    void learnModel();
+    void runPid(float dt);
+    void runAutoTune();
+    void updateOutput();
+    void setRelay(bool on);
+    bool isRelayLive();                               // Switched on and no longer queued
+    void relayOff();                                  // Unconditional - resyncs relayOn
+    void enterFault(const char* reason);
+};
+
+#endif // HEATERCONTROLLER_H
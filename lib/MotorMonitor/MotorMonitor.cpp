@@ -0,0 +1,199 @@
+/*
+ * Motor Monitor Implementation
+ */
+
+#include "MotorMonitor.h"
+#include <Preferences.h>
+#include <LogController.h>
+
+extern Preferences preferences;
+extern LogController logger;
+
+MotorMonitor::MotorMonitor() {
+    adc = nullptr;
+    channel = 0;
+    ampsPerVolt = 1;
+    defaultJamAmps = 0;
+    name = "Motor";
+    prefKey = nullptr;
+    sensorOk = false;
+    baseline = 0;
+    savedBaseline = 0;
+    running = false;
+    paused = false;
+    overcurrent = false;
+    stable = false;
+    startTime = 0;
+    blankTime = INRUSH_BLANK;
+    lastSample = 0;
+    current = 0;
+    peak = 0;
+    runSum = 0;
+    runCount = 0;
+    overCount = 0;
+    memset(trend, 0, sizeof(trend));
+    trendIndex = 0;
+    trendCount = 0;
+    trendTick = 0;
+    jamCount = 0;
+}
+
+void MotorMonitor::init(AdcScanController* scanner, uint8_t adcChannel, float scale, float jamAmps,
+                        const char* motorName, const char* key) {
+    adc = scanner;
+    channel = adcChannel;
+    ampsPerVolt = scale;
+    defaultJamAmps = jamAmps;
+    name = motorName;
+    prefKey = key;
+
+    if (prefKey) {
+        baseline = preferences.getFloat(prefKey, 0);
+        if (isnan(baseline) || baseline < 0) baseline = 0;
+    }
+    savedBaseline = baseline;
+    logger.info(name, "Current monitor initialized");
+    if (baseline > 0) {
+        logger.debug(name, "Learned current (mA)", (int)(baseline * 1000));
+    }
+}
+
+void MotorMonitor::begin() {
+    running = true;
+    paused = false;
+    overcurrent = false;
+    stable = false;
+    startTime = millis();
+    blankTime = INRUSH_BLANK;
+    lastSample = 0;
+    peak = 0;
+    runSum = 0;
+    runCount = 0;
+    overCount = 0;
+    trendIndex = 0;
+    trendCount = 0;
+    trendTick = 0;
+    configureStability();
+}
+
+void MotorMonitor::end(bool completed) {
+    if (!running) return;
+    running = false;
+    paused = false;
+
+    // Only a full, normal run teaches the signature - not one cut short
+    // by a pause, stop or fault
+    if (!completed || overcurrent || runCount < MIN_LEARN_SAMPLES) return;
+    float mean = runSum / runCount;
+    baseline = (baseline <= 0) ? mean : baseline + (mean - baseline) * LEARN_RATE;
+    saveBaseline();
+}
+
+// Motor off, run verdicts held - samples resume where they left off
+void MotorMonitor::pause() {
+    if (!running || paused) return;
+    paused = true;
+    overCount = 0;
+}
+
+void MotorMonitor::resume() {
+    if (!paused) return;
+    paused = false;
+    startTime = millis();
+    blankTime = RESTART_BLANK;
+}
+
+float MotorMonitor::getJamLimit() {
+    return (baseline > 0) ? baseline * JAM_RATIO : defaultJamAmps;
+}
+
+void MotorMonitor::update() {
+    if (adc == nullptr) return;
+
+    unsigned long now = millis();
+    if (now - lastSample < SAMPLE_INTERVAL) return;
+    lastSample = now;
+
+    if (!adc->isFresh(channel, SAMPLE_INTERVAL * 2)) {
+        sensorOk = false;
+        overcurrent = false;
+        stable = false;
+        return;
+    }
+    sensorOk = true;
+    current = adc->getVolts(channel) * ampsPerVolt;
+    if (current < 0) current = 0;
+
+    if (!running || paused || now - startTime < blankTime) return;
+
+    if (current > peak) peak = current;
+    runSum += current;
+    if (runCount < 0xFFFF) runCount++;
+
+    // Jam: sustained current over the limit
+    float limit = getJamLimit();
+    if (limit > 0 && current > limit) {
+        if (overCount < JAM_SAMPLES) overCount++;
+        if (overCount >= JAM_SAMPLES && !overcurrent) {
+            overcurrent = true;
+            jamCount++;
+            logger.warning(name, "Overcurrent (mA)", (int)(current * 1000));
+        }
+    } else {
+        overCount = 0;
+    }
+
+    int32_t milliamps = (int32_t)(current * 1000);
+    bool quiet = settle.add(milliamps);
+    if (++trendTick >= 1000 / SAMPLE_INTERVAL) {
+        trendTick = 0;
+        trend[trendIndex] = settle.getMean();
+        trendIndex = (trendIndex + 1) % TREND_SECONDS;
+        if (trendCount < TREND_SECONDS) trendCount++;
+    }
+
+    bool wasStable = stable;
+    stable = quiet && isTrendFlat(settle.getMean());
+    if (stable && !wasStable) {
+        logger.debug(name, "Load stable (mA)", (int)settle.getMean());
+    }
+}
+
+// Quiet enough relative to the motor's own running current
+void MotorMonitor::configureStability() {
+    float spread = baseline * STABLE_SPREAD;
+    if (spread < MIN_STABLE_SPREAD) spread = MIN_STABLE_SPREAD;
+    float milliamps = spread * 1000;
+    settle.configure((uint32_t)(milliamps * milliamps), STABLE_HOLD);
+}
+
+// Oldest second in the ring vs the current window mean
+bool MotorMonitor::isTrendFlat(int32_t mean) {
+    if (trendCount < TREND_SECONDS) return false;
+    int32_t oldest = trend[trendIndex];
+    int32_t drift = abs(mean - oldest);
+    int32_t allowed = (int32_t)(abs(mean) * STABLE_DRIFT);
+    int32_t minimum = (int32_t)(MIN_STABLE_SPREAD * 1000);
+    return drift <= ((allowed > minimum) ? allowed : minimum);
+}
+
+void MotorMonitor::saveBaseline() {
+    // One run moves the signature by LEARN_RATE at most - only a real shift earns a write
+    if (prefKey == nullptr || fabs(baseline - savedBaseline) < savedBaseline * SAVE_CHANGE) return;
+    preferences.putFloat(prefKey, baseline);
+    savedBaseline = baseline;
+    logger.debug(name, "Current signature saved (mA)", (int)(baseline * 1000));
+}
+
+void MotorMonitor::logStatistics() {
+    if (!sensorOk) return;
+    if (running) {
+        logger.debug(name, "Current (mA)", (int)(current * 1000));
+    }
+    if (baseline > 0) {
+        logger.verbose(name, "Learned current (mA)", (int)(baseline * 1000));
+    }
+    if (jamCount > 0) {
+        logger.debug(name, "Overcurrent trips", (int)jamCount);
+    }
+}
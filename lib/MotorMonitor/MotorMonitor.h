@@ -0,0 +1,107 @@
+/*
+ * Motor Monitor
+ * Current-clamp load signature of one motor (mixer or shredder)
+ *
+ * The clamp's DC output is read from the ADS1115 scan every 100 ms while
+ * the motor runs; the start inrush is blanked. Each motor keeps a learned
+ * signature - the mean running current of a normal run, stored in
+ * Preferences - that sets its overcurrent (jam) limit and how quiet the
+ * load must be to count as stable. Stable means the windowed spread is
+ * small and the mean has stopped drifting: for the mixer, the pulp is
+ * through. A planned stop (duty-cycle rest) pauses the run: the window and
+ * trend carry over, and a restart only re-blanks its own inrush.
+ * Call update() in loop.
+ */
+
+#ifndef MOTORMONITOR_H
+#define MOTORMONITOR_H
+
+#include <Arduino.h>
+#include <AdcScanController.h>
+#include <SignalFilter.h>
+
+class MotorMonitor {
+public:
+    static const uint8_t TREND_SECONDS = 5;           // Drift measured over this span
+
+    MotorMonitor();
+
+    // Initialization - amps = volts * ampsPerVolt; jamAmps applies until a signature is learned
+    void init(AdcScanController* adc, uint8_t channel, float ampsPerVolt, float jamAmps,
+              const char* name, const char* prefKey);
+    void update();
+
+    // Run (called around each motor start/stop)
+    void begin();
+    void end(bool completed);                         // Learns only from a clean, completed run
+    void pause();                                     // Planned stop within the run
+    void resume();
+    bool isRunning() { return running; }
+    bool isPaused() { return paused; }
+
+    // Verdicts for the current run
+    bool isOvercurrent() { return running && overcurrent; }
+    bool isStable() { return running && !paused && stable; }
+
+    // Status
+    bool isSensorOk() { return sensorOk; }
+    float getCurrent() { return current; }            // A
+    float getPeak() { return peak; }                  // This run, after the inrush
+    float getBaseline() { return baseline; }          // Learned running current, 0 = none yet
+    float getJamLimit();
+    uint32_t getJamCount() { return jamCount; }
+    void logStatistics();
+
+private:
+    AdcScanController* adc;
+    uint8_t channel;
+    float ampsPerVolt;
+    float defaultJamAmps;
+    const char* name;
+    const char* prefKey;
+    bool sensorOk;
+
+    // Signature
+    float baseline;
+    float savedBaseline;
+
+    // Current run
+    bool running;
+    bool paused;
+    bool overcurrent;
+    bool stable;
+    unsigned long startTime;
+    unsigned long blankTime;                          // Inrush blank of the latest start
+    unsigned long lastSample;
+    float current;
+    float peak;
+    float runSum;
+    uint16_t runCount;
+    uint8_t overCount;
+    SettleDetector settle;
+    int32_t trend[TREND_SECONDS];                     // Window mean once a second (mA)
+    uint8_t trendIndex;
+    uint8_t trendCount;
+    uint8_t trendTick;
+
+    uint32_t jamCount;
+
+    void configureStability();
+    bool isTrendFlat(int32_t mean);
+    void saveBaseline();
+
+    static const unsigned long SAMPLE_INTERVAL = 100;     // ms
+    static const unsigned long INRUSH_BLANK = 2000;       // ms after a start before judging
+    static const unsigned long RESTART_BLANK = 1000;      // ms after a resume - the load is already broken up
+    static const uint8_t JAM_SAMPLES = 3;                 // Over the limit this long = jam
+    static const uint8_t STABLE_HOLD = 20;                // Quiet samples for a stable verdict
+    static const uint16_t MIN_LEARN_SAMPLES = 50;         // Run length the signature learns from
+    static constexpr float JAM_RATIO = 1.8f;              // Jam limit vs the learned current
+    static constexpr float LEARN_RATE = 0.2f;             // Per run
+    static constexpr float SAVE_CHANGE = 0.1f;            // Signature shift worth a flash write
+    static constexpr float STABLE_SPREAD = 0.03f;         // Std dev vs the learned current
+    static constexpr float MIN_STABLE_SPREAD = 0.05f;     // A
+    static constexpr float STABLE_DRIFT = 0.03f;          // Mean change over TREND_SECONDS
+};
+
+#endif // MOTORMONITOR_H
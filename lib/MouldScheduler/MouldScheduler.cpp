@@ -0,0 +1,388 @@
+/*
+ * Mould Scheduler Implementation
+ */
+
+#include "MouldScheduler.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+MouldScheduler::MouldScheduler() {
+    relayControl = nullptr;
+    memset(&relays, 0, sizeof(relays));
+    dualMode = false;
+    suctionTime = 8000;
+    blowTime = 5000;
+    delayTime = 2000;
+    suctionMonitor = nullptr;
+    pendingCheck = nullptr;
+    phase = MOULD_PHASE_IDLE;
+    phaseStart = 0;
+    cycleStart = 0;
+    vatMould = MOULD_A;
+    vacuumOn = false;
+    blowerOn = false;
+    vacuumMould = MOULD_A;
+    blowerMould = MOULD_A;
+    vacuumLive = false;
+    blowerLive = false;
+    vacuumSince = 0;
+    blowerSince = 0;
+    liftDown = false;
+    liftChanged = 0;
+    carriageB = false;
+    carriageKnown = false;
+    carriageChanged = 0;
+    memset(holdsTray, 0, sizeof(holdsTray));
+    memset(trayDefects, 0, sizeof(trayDefects));
+    trayReleased = false;
+    releasedDefects = 0;
+    blowingOff = false;
+    cycleCount = 0;
+    avgCycleMs = 0;
+    lastSuctionMs = 0;
+    lastSavedMs = 0;
+    totalSavedMs = 0;
+    endpointCount = 0;
+}
+
+void MouldScheduler::init(void (*relayCallback)(uint8_t relayIndex, bool state), const MouldRelays& relayMap) {
+    relayControl = relayCallback;
+    relays = relayMap;
+    vatMould = MOULD_A;
+    allOff();
+    setOutput(relays.position, false);
+    carriageB = false;
+    carriageKnown = true;
+    carriageChanged = millis();
+    logger.info("Mould", "Mould scheduler initialized");
+}
+
+void MouldScheduler::setDualMode(bool enabled) {
+    if (enabled == dualMode) return;
+    if (isCycleActive()) return;            // Takes effect between cycles
+    if (enabled && relays.position == MOULD_NO_RELAY) {
+        logger.warning("Mould", "Dual mould needs the carriage relay");
+        return;
+    }
+    dualMode = enabled;
+    logger.info("Mould", enabled ? "Dual mould A/B" : "Single mould A");
+}
+
+void MouldScheduler::setTimings(unsigned long suctionMs, unsigned long blowMs, unsigned long delayMs) {
+    suctionTime = suctionMs;
+    blowTime = blowMs;
+    delayTime = delayMs;
+}
+
+bool MouldScheduler::startCycle(uint8_t defects) {
+    if (isCycleActive()) {
+        logger.warning("Mould", "Cycle already running");
+        return false;
+    }
+
+    // Single mode always moulds on A
+    if (!dualMode) {
+        vatMould = MOULD_A;
+    }
+
+    trayDefects[vatMould] = defects;
+    trayReleased = false;
+    releasedDefects = 0;
+    cycleStart = millis();
+    enterPhase(isCarriageAt(vatMould == MOULD_B) ? MOULD_PHASE_FORM : MOULD_PHASE_POSITION);
+    return true;
+}
+
+void MouldScheduler::update() {
+    if (!isCycleActive()) return;
+
+    trackLoads();
+    unsigned long now = millis();
+    unsigned long elapsed = now - phaseStart;
+
+    switch (phase) {
+        case MOULD_PHASE_POSITION:
+            if (isCarriageAt(vatMould == MOULD_B)) {
+                enterPhase(MOULD_PHASE_FORM);
+            } else {
+                moveCarriage(vatMould == MOULD_B);
+            }
+            break;
+
+        case MOULD_PHASE_FORM:
+            if (vacuumOn && vacuumLive) {
+                // Vacuum plateau = cake formed; the suction time is the upper bound
+                unsigned long suction = now - vacuumSince;
+                bool atEndpoint = suctionMonitor && suctionMonitor->isEndpoint() && suction < suctionTime;
+                if (atEndpoint || suction >= suctionTime) {
+                    endSuction(suction, atEndpoint);
+                }
+            }
+            if (blowerOn && blowerLive && now - blowerSince >= blowTime) {
+                // Previous tray blown off the transfer mould
+                stopBlower();
+                MouldId transfer = otherMould(vatMould);
+                holdsTray[transfer] = false;
+                trayReleased = true;
+                releasedDefects = trayDefects[transfer];
+            }
+            if (!vacuumOn && !blowerOn) {
+                holdsTray[vatMould] = true;
+                if (dualMode) {
+                    enterPhase(MOULD_PHASE_RAISE);
+                } else {
+                    enterPhase(MOULD_PHASE_BLOW);
+                }
+            }
+            break;
+
+        case MOULD_PHASE_BLOW:
+            if (blowerLive && now - blowerSince >= blowTime) {
+                stopBlower();
+                holdsTray[vatMould] = false;
+                trayReleased = true;
+                releasedDefects = trayDefects[vatMould];
+                enterPhase(MOULD_PHASE_TRANSFER);
+            }
+            break;
+
+        case MOULD_PHASE_RAISE:
+            // Swap once the vat mould is clear of the pulp: the new tray goes to
+            // the transfer station, the empty mould to the vat
+            if (moveCarriage(otherMould(vatMould) == MOULD_B)) {
+                vatMould = otherMould(vatMould);
+                enterPhase(MOULD_PHASE_TRANSFER);
+            }
+            break;
+
+        case MOULD_PHASE_TRANSFER:
+            if (elapsed >= delayTime) {
+                finishCycle();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void MouldScheduler::enterPhase(MouldPhase newPhase) {
+    phase = newPhase;
+    phaseStart = millis();
+
+    switch (phase) {
+        case MOULD_PHASE_POSITION:
+            setLift(false);
+            break;
+
+        case MOULD_PHASE_FORM:
+            // Vat mould down into the pulp under vacuum
+            setLift(true);
+            startVacuum(vatMould);
+            blowingOff = dualMode && holdsTray[otherMould(vatMould)];
+            if (blowingOff) {
+                startBlower(otherMould(vatMould));
+            }
+            break;
+
+        case MOULD_PHASE_BLOW:
+            setLift(false);
+            startBlower(vatMould);
+            break;
+
+        case MOULD_PHASE_RAISE:
+        case MOULD_PHASE_TRANSFER:
+            setLift(false);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void MouldScheduler::abort() {
+    allOff();
+}
+
+void MouldScheduler::resume() {
+    if (!isCycleActive()) return;
+    // Phase restarts in full - a partly formed or blown tray needs the whole time again
+    enterPhase(phase);
+}
+
+void MouldScheduler::reset() {
+    allOff();
+    phase = MOULD_PHASE_IDLE;
+    memset(holdsTray, 0, sizeof(holdsTray));
+    trayReleased = false;
+    releasedDefects = 0;
+    // Outputs may have been switched behind our back (test mode, manual toggles):
+    // count the lift as just raised and re-drive the carriage at the next POSITION phase
+    liftDown = false;
+    liftChanged = millis();
+    carriageKnown = false;
+}
+
+void MouldScheduler::finishCycle() {
+    unsigned long cycleTime = millis() - cycleStart;
+    cycleCount++;
+    avgCycleMs = (cycleCount == 1) ? cycleTime : avgCycleMs + (cycleTime - avgCycleMs) * 0.2f;
+    phase = MOULD_PHASE_DONE;
+    logger.debug("Mould", "Cycle time (ms)", cycleTime);
+}
+
+void MouldScheduler::endSuction(unsigned long elapsed, bool atEndpoint) {
+    stopVacuum();
+    lastSuctionMs = elapsed;
+    lastSavedMs = atEndpoint ? suctionTime - elapsed : 0;
+    if (atEndpoint) {
+        totalSavedMs += lastSavedMs;
+        endpointCount++;
+        logger.debug("Mould", "Suction end-point, saved (ms)", lastSavedMs);
+    }
+}
+
+void MouldScheduler::startVacuum(MouldId mould) {
+    // Selector only moves while the pump is off
+    if (vacuumOn) stopVacuum();
+    setOutput(relays.vacuumSelect, mould == MOULD_B);
+    setOutput(relays.mouldValve[mould], true);
+    setOutput(relays.vacuum, true);
+    vacuumOn = true;
+    vacuumLive = false;
+    vacuumMould = mould;
+    trackLoads();
+}
+
+void MouldScheduler::stopVacuum() {
+    setOutput(relays.vacuum, false);
+    vacuumOn = false;
+    vacuumLive = false;
+    if (suctionMonitor) {
+        suctionMonitor->end();
+    }
+    // Keep the valve open if the blower is still using this mould
+    if (!(blowerOn && blowerMould == vacuumMould)) {
+        setOutput(relays.mouldValve[vacuumMould], false);
+    }
+}
+
+void MouldScheduler::startBlower(MouldId mould) {
+    if (blowerOn) stopBlower();
+    setOutput(relays.blowerSelect, mould == MOULD_B);
+    setOutput(relays.mouldValve[mould], true);
+    setOutput(relays.blower, true);
+    blowerOn = true;
+    blowerLive = false;
+    blowerMould = mould;
+    trackLoads();
+}
+
+void MouldScheduler::stopBlower() {
+    setOutput(relays.blower, false);
+    blowerOn = false;
+    blowerLive = false;
+    if (!(vacuumOn && vacuumMould == blowerMould)) {
+        setOutput(relays.mouldValve[blowerMould], false);
+    }
+}
+
+void MouldScheduler::allOff() {
+    setOutput(relays.vacuum, false);
+    setOutput(relays.blower, false);
+    setOutput(relays.mouldValve[MOULD_A], false);
+    setOutput(relays.mouldValve[MOULD_B], false);
+    setLift(false);
+    vacuumOn = false;
+    blowerOn = false;
+    vacuumLive = false;
+    blowerLive = false;
+    if (suctionMonitor) {
+        suctionMonitor->end();
+    }
+}
+
+void MouldScheduler::setOutput(uint8_t relay, bool state) {
+    if (relayControl && relay != MOULD_NO_RELAY) {
+        relayControl(relay, state);
+    }
+}
+
+bool MouldScheduler::isClosed(uint8_t relay) {
+    return pendingCheck == nullptr || !pendingCheck(relay);
+}
+
+// Pump timers (and the vacuum end-point) start once the pump has actually started
+void MouldScheduler::trackLoads() {
+    unsigned long now = millis();
+    if (vacuumOn && !vacuumLive && isClosed(relays.vacuum)) {
+        vacuumLive = true;
+        vacuumSince = now;
+        if (suctionMonitor) {
+            suctionMonitor->begin();
+        }
+    }
+    if (blowerOn && !blowerLive && isClosed(relays.blower)) {
+        blowerLive = true;
+        blowerSince = now;
+    }
+}
+
+void MouldScheduler::setLift(bool down) {
+    setOutput(relays.lift, down);
+    if (down != liftDown) {
+        liftDown = down;
+        liftChanged = millis();
+    }
+}
+
+bool MouldScheduler::moveCarriage(bool toB) {
+    if (carriageKnown && carriageB == toB) return true;
+    if (liftDown || millis() - liftChanged < LIFT_SETTLE_TIME) return false;
+    setOutput(relays.position, toB);
+    carriageB = toB;
+    carriageKnown = true;
+    carriageChanged = millis();
+    return true;
+}
+
+bool MouldScheduler::isCarriageAt(bool toB) {
+    if (relays.position == MOULD_NO_RELAY) return !toB;     // Fixed on A
+    return carriageKnown && carriageB == toB && millis() - carriageChanged >= CARRIAGE_SETTLE_TIME;
+}
+
+const char* MouldScheduler::getPhaseName() {
+    switch (phase) {
+        case MOULD_PHASE_POSITION: return "Position";
+        case MOULD_PHASE_FORM:     return blowingOff ? "Suck+Blow" : "Suction";
+        case MOULD_PHASE_BLOW:     return "Blow";
+        case MOULD_PHASE_RAISE:    return "Raise";
+        case MOULD_PHASE_TRANSFER: return "Transfer";
+        case MOULD_PHASE_DONE:     return "Done";
+        default:                   return "Idle";
+    }
+}
+
+float MouldScheduler::getTraysPerHour() {
+    if (cycleCount == 0 || avgCycleMs <= 0) return 0;
+    return 3600000.0f / avgCycleMs;
+}
+
+float MouldScheduler::getSingleMouldTraysPerHour() {
+    unsigned long cycle = suctionTime + blowTime + delayTime;
+    if (cycle == 0) return 0;
+    return 3600000.0f / cycle;
+}
+
+void MouldScheduler::logStatistics() {
+    if (cycleCount == 0) return;
+    logger.debug("Mould", "Cycles", (int)cycleCount);
+    logger.debug("Mould", "Average cycle (ms)", getAverageCycleTime());
+    logger.debug("Mould", "Trays/hour", (int)getTraysPerHour());
+    logger.debug("Mould", "Single mould trays/hour", (int)getSingleMouldTraysPerHour());
+    if (endpointCount > 0) {
+        logger.debug("Mould", "Suction end-points", (int)endpointCount);
+        logger.debug("Mould", "Suction saved (s)", (int)(totalSavedMs / 1000));
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * Mould Scheduler
+ * Dual-mould A/B ping-pong moulding cycle
+ *
+ * One mould sits in the pulp vat while the other sits over the transfer
+ * station. In dual mode the vat mould runs suction while the transfer
+ * mould blows off the tray it formed in the previous cycle, then the
+ * moulds swap. A single vacuum pump and a single blower are shared via the
+ * Vacuum A/B and Blower A/B selectors, which are only switched while their
+ * pump is off. Single mode runs suction, blow and delay on mould A.
+ * With a suction monitor, suction ends at the vacuum end-point; the
+ * suction time is then only the upper bound. Suction and blow times run
+ * from when the pump actually starts, not from the (maybe queued) request.
+ * The carriage only traverses
+ * once the lift has been up for a settle time, and a mould is only lowered
+ * once the carriage has settled - never both in one tick.
+ */
+
+#ifndef MOULDSCHEDULER_H
+#define MOULDSCHEDULER_H
+
+#include <Arduino.h>
+#include <SuctionMonitor.h>
+
+enum MouldId {
+    MOULD_A,
+    MOULD_B,
+    MOULD_COUNT
+};
+
+enum MouldPhase {
+    MOULD_PHASE_IDLE,
+    MOULD_PHASE_POSITION,     // Lift up, carriage to the vat mould before lowering
+    MOULD_PHASE_FORM,         // Suction on the vat mould (dual: blow-off on the other)
+    MOULD_PHASE_BLOW,         // Single mode: blow-off after suction
+    MOULD_PHASE_RAISE,        // Dual mode: lift up and settled before the swap
+    MOULD_PHASE_TRANSFER,     // Swap/transfer, cycle delay
+    MOULD_PHASE_DONE
+};
+
+#define MOULD_NO_RELAY 0xFF   // Output not fitted (e.g. no carriage - single mould only)
+
+// Relay indices (setRelay numbering)
+struct MouldRelays {
+    uint8_t vacuum;           // Vacuum pump
+    uint8_t blower;           // Blower
+    uint8_t vacuumSelect;     // Vacuum A/B selector (off = A, on = B)
+    uint8_t blowerSelect;     // Blower A/B selector (off = A, on = B)
+    uint8_t mouldValve[MOULD_COUNT];  // Mould A/B V/B valve - connects the mould to its line
+    uint8_t position;         // Fwd/Rev - off = A over the vat, on = B over the vat
+    uint8_t lift;             // Up/Down - on lowers the vat mould into the pulp
+};
+
+class MouldScheduler {
+public:
+    MouldScheduler();
+
+    void init(void (*relayControl)(uint8_t relayIndex, bool state), const MouldRelays& relays);
+    void setDualMode(bool enabled);
+    void setTimings(unsigned long suctionMs, unsigned long blowMs, unsigned long delayMs);
+    void setSuctionMonitor(SuctionMonitor* monitor) { suctionMonitor = monitor; }
+    // Start of a relay still queued (e.g. on the supply budget) - nullptr = switches at once
+    void setPendingCheck(bool (*isPending)(uint8_t relayIndex)) { pendingCheck = isPending; }
+
+    // One cycle forms a tray carrying this verdict on the vat mould
+    bool startCycle(uint8_t defects);
+    void update();
+    void abort();                             // Outputs off, mould contents kept
+    void resume();                            // Restart the current phase after abort()
+    void reset();                             // Forget moulds' contents (new run)
+
+    bool isCycleActive() { return phase != MOULD_PHASE_IDLE && phase != MOULD_PHASE_DONE; }
+    bool isCycleDone() { return phase == MOULD_PHASE_DONE; }
+    MouldPhase getPhase() { return phase; }
+    const char* getPhaseName();
+
+    // Tray released at the transfer station by the last cycle
+    bool hasReleasedTray() { return trayReleased; }
+    uint8_t getReleasedDefects() { return releasedDefects; }
+
+    // Statistics
+    bool isDualMode() { return dualMode; }
+    MouldId getVatMould() { return vatMould; }
+    uint32_t getCycleCount() { return cycleCount; }
+    unsigned long getAverageCycleTime() { return (unsigned long)avgCycleMs; }
+    float getTraysPerHour();                  // Measured
+    float getSingleMouldTraysPerHour();       // Same timings on one mould
+    unsigned long getLastSuctionTime() { return lastSuctionMs; }
+    unsigned long getLastSuctionSaved() { return lastSavedMs; }     // vs the suction time
+    unsigned long getTotalSuctionSaved() { return totalSavedMs; }
+    uint32_t getEndpointCount() { return endpointCount; }
+    void logStatistics();
+
+private:
+    void (*relayControl)(uint8_t relayIndex, bool state);
+    MouldRelays relays;
+    bool dualMode;
+    unsigned long suctionTime;
+    unsigned long blowTime;
+    unsigned long delayTime;
+    SuctionMonitor* suctionMonitor;
+    bool (*pendingCheck)(uint8_t relayIndex);
+
+    MouldPhase phase;
+    unsigned long phaseStart;
+    unsigned long cycleStart;
+    MouldId vatMould;
+    bool vacuumOn;
+    bool blowerOn;
+    MouldId vacuumMould;                      // Mould the vacuum selector points at
+    MouldId blowerMould;
+    bool vacuumLive;                          // Pump actually running
+    bool blowerLive;
+    unsigned long vacuumSince;
+    unsigned long blowerSince;
+    bool liftDown;
+    unsigned long liftChanged;
+    bool carriageB;                           // Position output (on = B over the vat)
+    bool carriageKnown;                       // false = re-drive before lowering (outputs touched outside)
+    unsigned long carriageChanged;
+
+    // Tray held on each mould and its verdict
+    bool holdsTray[MOULD_COUNT];
+    uint8_t trayDefects[MOULD_COUNT];
+    bool trayReleased;
+    uint8_t releasedDefects;
+    bool blowingOff;                          // Dual FORM phase also blows the transfer mould
+
+    uint32_t cycleCount;
+    float avgCycleMs;
+    unsigned long lastSuctionMs;
+    unsigned long lastSavedMs;
+    unsigned long totalSavedMs;
+    uint32_t endpointCount;
+
+    MouldId otherMould(MouldId mould) { return (mould == MOULD_A) ? MOULD_B : MOULD_A; }
+    void setOutput(uint8_t relay, bool state);
+    bool isClosed(uint8_t relay);
+    void trackLoads();
+    void setLift(bool down);
+    bool moveCarriage(bool toB);              // false while the lift has not settled up
+    bool isCarriageAt(bool toB);              // There and settled
+    void enterPhase(MouldPhase newPhase);
+    void startVacuum(MouldId mould);
+    void stopVacuum();
+    void endSuction(unsigned long elapsed, bool atEndpoint);
+    void startBlower(MouldId mould);
+    void stopBlower();
+    void allOff();
+    void finishCycle();
+
+    static const unsigned long LIFT_SETTLE_TIME = 1500;       // ms up before the carriage moves
+    static const unsigned long CARRIAGE_SETTLE_TIME = 1000;   // ms after a move before lowering
+};
+
+#endif // MOULDSCHEDULER_H
@@ -0,0 +1,227 @@
+/*
+ * Power Budget Implementation
+ */
+
+#include "PowerBudget.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+PowerBudget::PowerBudget() {
+    budget = 0;
+    relayControl = nullptr;
+    memset(loads, 0, sizeof(loads));
+    loadCount = 0;
+    memset(queue, 0, sizeof(queue));
+    queueCount = 0;
+    peakDraw = 0;
+}
+
+void PowerBudget::init(float budgetAmps, void (*relayCallback)(uint8_t relayIndex, bool state)) {
+    budget = budgetAmps;
+    relayControl = relayCallback;
+    logger.info("Power", "Load sequencing initialized");
+}
+
+bool PowerBudget::addLoad(const PowerLoadConfig& config) {
+    if (loadCount >= MAX_LOADS || isRated(config.relay)) return false;
+
+    PowerLoad& load = loads[loadCount++];
+    memset(&load, 0, sizeof(load));
+    load.config = config;
+    return true;
+}
+
+int8_t PowerBudget::findLoad(uint8_t relay) {
+    for (uint8_t i = 0; i < loadCount; i++) {
+        if (loads[i].config.relay == relay) return i;
+    }
+    return -1;
+}
+
+void PowerBudget::requestOn(uint8_t relay) {
+    int8_t index = findLoad(relay);
+    if (index < 0) {
+        // Unrated - nothing to budget
+        if (relayControl) {
+            relayControl(relay, true);
+        }
+        return;
+    }
+
+    PowerLoad& load = loads[index];
+    if (load.on || load.pending) return;
+    load.pending = true;
+    load.requestTime = millis();
+    queue[queueCount++] = index;
+    dispatch();
+}
+
+void PowerBudget::turnOff(uint8_t relay) {
+    int8_t index = findLoad(relay);
+    if (index < 0) return;
+
+    PowerLoad& load = loads[index];
+    if (load.pending) {
+        for (uint8_t pos = 0; pos < queueCount; pos++) {
+            if (queue[pos] == index) {
+                removeQueued(pos);
+                break;
+            }
+        }
+        load.pending = false;
+    }
+    load.on = false;
+}
+
+void PowerBudget::cancelAll() {
+    for (uint8_t pos = 0; pos < queueCount; pos++) {
+        loads[queue[pos]].pending = false;
+    }
+    queueCount = 0;
+}
+
+void PowerBudget::update() {
+    if (queueCount > 0) {
+        dispatch();
+    }
+}
+
+float PowerBudget::loadDraw(const PowerLoad& load, unsigned long onSince, unsigned long t) {
+    return (t - onSince < load.config.inrushMs) ? load.config.inrushAmps : load.config.steadyAmps;
+}
+
+// Draw of the loads that are on, at time t (>= now)
+float PowerBudget::drawAt(unsigned long t) {
+    float draw = 0;
+    for (uint8_t i = 0; i < loadCount; i++) {
+        if (loads[i].on) {
+            draw += loadDraw(loads[i], loads[i].onSince, t);
+        }
+    }
+    return draw;
+}
+
+// Soonest time the load's inrush fits - draw only drops when a running
+// inrush ends, so those are the only times worth checking
+unsigned long PowerBudget::earliestFit(uint8_t index, unsigned long now) {
+    float need = loads[index].config.inrushAmps;
+    if (drawAt(now) + need <= budget) return now;
+
+    unsigned long best = NEVER;
+    for (uint8_t i = 0; i < loadCount; i++) {
+        if (!loads[i].on) continue;
+        unsigned long inrushEnd = loads[i].onSince + loads[i].config.inrushMs;
+        if ((long)(inrushEnd - now) <= 0) continue;
+        if (best != NEVER && inrushEnd - now >= best - now) continue;
+        if (drawAt(inrushEnd) + need <= budget) {
+            best = inrushEnd;
+        }
+    }
+    return best;
+}
+
+// Would starting this load now push back the request at the head of the queue?
+bool PowerBudget::delaysHead(uint8_t index, unsigned long headFit, uint8_t head, unsigned long now) {
+    if (headFit == NEVER) {
+        // Head waits for a load to go off. A smaller start may go ahead as long
+        // as the biggest running load going off still makes room for the head.
+        float steady = loads[index].config.steadyAmps;
+        float largest = 0;
+        for (uint8_t i = 0; i < loadCount; i++) {
+            if (!loads[i].on) continue;
+            steady += loads[i].config.steadyAmps;
+            if (loads[i].config.steadyAmps > largest) largest = loads[i].config.steadyAmps;
+        }
+        return steady - largest + loads[head].config.inrushAmps > budget;
+    }
+    float draw = drawAt(headFit) + loadDraw(loads[index], now, headFit);
+    return draw + loads[head].config.inrushAmps > budget;
+}
+
+void PowerBudget::dispatch() {
+    unsigned long now = millis();
+    bool released = true;
+
+    while (released && queueCount > 0) {
+        released = false;
+        uint8_t head = queue[0];
+        float draw = drawAt(now);
+
+        // A load too big for the budget on its own still starts on an idle supply
+        if (draw + loads[head].config.inrushAmps <= budget || draw <= 0) {
+            release(0, now);
+            released = true;
+            continue;
+        }
+
+        unsigned long headFit = earliestFit(head, now);
+        for (uint8_t pos = 1; pos < queueCount; pos++) {
+            uint8_t index = queue[pos];
+            if (draw + loads[index].config.inrushAmps > budget) continue;
+            if (delaysHead(index, headFit, head, now)) continue;
+            release(pos, now);
+            released = true;
+            break;
+        }
+    }
+}
+
+void PowerBudget::release(uint8_t queuePos, unsigned long now) {
+    PowerLoad& load = loads[queue[queuePos]];
+    removeQueued(queuePos);
+
+    load.pending = false;
+    load.on = true;
+    load.onSince = now;
+    load.starts++;
+
+    unsigned long deferred = now - load.requestTime;
+    load.lastDeferMs = deferred;
+    if (deferred > 0) {
+        load.deferredStarts++;
+        load.totalDeferMs += deferred;
+        if (deferred > load.maxDeferMs) load.maxDeferMs = deferred;
+        logger.debug(load.config.name, "Start deferred (ms)", deferred);
+    }
+
+    if (relayControl) {
+        relayControl(load.config.relay, true);
+    }
+
+    float draw = drawAt(now);
+    if (draw > peakDraw) peakDraw = draw;
+}
+
+void PowerBudget::removeQueued(uint8_t queuePos) {
+    for (uint8_t pos = queuePos; pos + 1 < queueCount; pos++) {
+        queue[pos] = queue[pos + 1];
+    }
+    queueCount--;
+}
+
+bool PowerBudget::isPending(uint8_t relay) {
+    int8_t index = findLoad(relay);
+    return index >= 0 && loads[index].pending;
+}
+
+unsigned long PowerBudget::getLastDeferral(uint8_t relay) {
+    int8_t index = findLoad(relay);
+    return (index >= 0) ? loads[index].lastDeferMs : 0;
+}
+
+void PowerBudget::logStatistics() {
+    if (peakDraw <= 0) return;
+    logger.debug("Power", "Draw (A)", (int)getDraw());
+    logger.verbose("Power", "Peak draw (A)", (int)peakDraw);
+    if (queueCount > 0) {
+        logger.debug("Power", "Starts waiting", (int)queueCount);
+    }
+    for (uint8_t i = 0; i < loadCount; i++) {
+        const PowerLoad& load = loads[i];
+        if (load.deferredStarts == 0) continue;
+        logger.debug(load.config.name, "Deferred starts", (int)load.deferredStarts);
+        logger.debug(load.config.name, "Max deferral (ms)", load.maxDeferMs);
+        logger.verbose(load.config.name, "Average deferral (ms)", (int)(load.totalDeferMs / load.deferredStarts));
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Power Budget
+ * Inrush-aware turn-on sequencing of the mains loads
+ *
+ * Each rated relay carries an inrush current, how long the inrush lasts
+ * and its steady-state current. Turning a rated load on is a request: it
+ * is switched at once when the supply budget has room for its inrush on
+ * top of what is already drawing, otherwise it is queued. Queued requests
+ * go in order; a later one may go first only if it fits now and would not
+ * delay the request at the head - or, when the head needs a running load
+ * to go off first, would not stop that making room. Turning off is never
+ * delayed. The time each start request waited is reported; timed phases
+ * count from isPending() going false, not from the request. Call update()
+ * in loop.
+ */
+
+#ifndef POWERBUDGET_H
+#define POWERBUDGET_H
+
+#include <Arduino.h>
+
+// Rating of one relay's load
+struct PowerLoadConfig {
+    const char* name;
+    uint8_t relay;
+    float inrushAmps;
+    unsigned long inrushMs;
+    float steadyAmps;
+};
+
+struct PowerLoad {
+    PowerLoadConfig config;
+    bool on;
+    bool pending;
+    unsigned long onSince;
+    unsigned long requestTime;
+    uint32_t starts;
+    uint32_t deferredStarts;
+    unsigned long lastDeferMs;
+    unsigned long maxDeferMs;
+    unsigned long totalDeferMs;
+};
+
+class PowerBudget {
+public:
+    static const uint8_t MAX_LOADS = 12;
+    static const unsigned long NEVER = 0xFFFFFFFFUL;
+
+    PowerBudget();
+
+    // Initialization - relayControl switches the relays (raw relay write)
+    void init(float budgetAmps, void (*relayControl)(uint8_t relayIndex, bool state));
+    bool addLoad(const PowerLoadConfig& config);
+    bool isRated(uint8_t relay) { return findLoad(relay) >= 0; }
+
+    // Switching
+    void requestOn(uint8_t relay);             // Now or once the budget allows
+    void turnOff(uint8_t relay);               // Also drops a queued request
+    void cancelAll();                          // Drop every queued request
+    void update();
+
+    // Status
+    bool isPending(uint8_t relay);
+    uint8_t getPendingCount() { return queueCount; }
+    float getDraw() { return drawAt(millis()); }   // A, inrush included
+    float getPeakDraw() { return peakDraw; }
+    unsigned long getLastDeferral(uint8_t relay);
+    void logStatistics();
+
+private:
+    float budget;
+    void (*relayControl)(uint8_t relayIndex, bool state);
+    PowerLoad loads[MAX_LOADS];
+    uint8_t loadCount;
+    uint8_t queue[MAX_LOADS];                  // Load indices, oldest request first
+    uint8_t queueCount;
+    float peakDraw;
+
+    int8_t findLoad(uint8_t relay);
+    float loadDraw(const PowerLoad& load, unsigned long onSince, unsigned long t);
+    float drawAt(unsigned long t);
+    unsigned long earliestFit(uint8_t index, unsigned long now);
+    bool delaysHead(uint8_t index, unsigned long headFit, uint8_t head, unsigned long now);
+    void dispatch();
+    void release(uint8_t queuePos, unsigned long now);
+    void removeQueued(uint8_t queuePos);
+};
+
+#endif // POWERBUDGET_H
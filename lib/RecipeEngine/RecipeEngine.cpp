@@ -0,0 +1,232 @@
+/*
+ * Recipe Engine Implementation
+ */
+
+#include "RecipeEngine.h"
+#include <Preferences.h>
+#include <LogController.h>
+
+extern Preferences preferences;
+extern LogController logger;
+
+RecipeEngine::RecipeEngine() {
+    builtIns = nullptr;
+    builtInCount = 0;
+    settings = nullptr;
+    settingCount = 0;
+    relayControl = nullptr;
+    pendingCheck = nullptr;
+    memset(&handlers, 0, sizeof(handlers));
+    memset(&active, 0, sizeof(active));
+    memset(&scratch, 0, sizeof(scratch));
+    selected = 0;
+    customValid = false;
+    customName[0] = '\0';
+    memset(skipped, 0, sizeof(skipped));
+    memset(frameLive, 0, sizeof(frameLive));
+    memset(frameWaitStart, 0, sizeof(frameWaitStart));
+    memset(frameWaitMs, 0, sizeof(frameWaitMs));
+}
+
+void RecipeEngine::init(const Recipe* recipes, uint8_t count, const int* const* settingTable, uint8_t tableSize,
+                        void (*relayCallback)(uint8_t relayIndex, bool state), const RecipeHandlers& recipeHandlers) {
+    builtIns = recipes;
+    builtInCount = count;
+    settings = settingTable;
+    settingCount = tableSize;
+    relayControl = relayCallback;
+    handlers = recipeHandlers;
+
+    customValid = loadCustom(scratch);
+    if (customValid) {
+        memcpy(customName, scratch.name, RECIPE_NAME_LENGTH);
+        customName[RECIPE_NAME_LENGTH - 1] = '\0';
+    }
+
+    uint8_t index = preferences.getInt("recipeSel", 0);
+    if (!select(index)) {
+        select(0);
+    }
+}
+
+uint8_t RecipeEngine::getRecipeCount() {
+    return builtInCount + (customValid ? CUSTOM_SLOT_COUNT : 0);
+}
+
+const char* RecipeEngine::getRecipeName(uint8_t index) {
+    if (index < builtInCount) return builtIns[index].name;
+    if (customValid && index == builtInCount) return customName;
+    return "";
+}
+
+bool RecipeEngine::select(uint8_t index) {
+    if (index < builtInCount) {
+        memcpy(&active, &builtIns[index], sizeof(Recipe));
+    } else if (customValid && index == builtInCount) {
+        if (!loadCustom(active)) return false;
+    } else {
+        return false;
+    }
+
+    if (!validate(active)) {
+        logger.error("Recipe", "Invalid recipe", getRecipeName(index));
+        return false;
+    }
+
+    if (index != selected) {
+        preferences.putInt("recipeSel", index);
+    }
+    selected = index;
+    logger.info("Recipe", "Selected", active.name);
+    return true;
+}
+
+bool RecipeEngine::validate(const Recipe& recipe) {
+    if (recipe.version != RECIPE_FORMAT_VERSION) return false;
+
+    for (uint8_t lane = 0; lane < RECIPE_LANE_COUNT; lane++) {
+        uint8_t count = recipe.stepCount[lane];
+        if (count == 0 || count > RECIPE_MAX_STEPS) return false;
+
+        for (uint8_t i = 0; i < count; i++) {
+            const RecipeStep& step = recipe.steps[lane][i];
+            if (step.next != RECIPE_NEXT_END && step.next >= count) return false;
+            if (step.source >= settingCount && step.source != RECIPE_SOURCE_FIXED) return false;
+            if (step.end > RECIPE_END_MIX) return false;
+        }
+    }
+    return true;
+}
+
+bool RecipeEngine::loadCustom(Recipe& recipe) {
+    if (preferences.getBytesLength("recipeC0") != sizeof(Recipe)) return false;
+    if (preferences.getBytes("recipeC0", &recipe, sizeof(Recipe)) != sizeof(Recipe)) return false;
+    return recipe.version == RECIPE_FORMAT_VERSION;
+}
+
+bool RecipeEngine::saveActiveAsCustom(const char* name) {
+    memcpy(&scratch, &active, sizeof(Recipe));
+    snprintf(scratch.name, RECIPE_NAME_LENGTH, "%s", name);
+
+    // Freeze the live settings into the stored recipe
+    for (uint8_t lane = 0; lane < RECIPE_LANE_COUNT; lane++) {
+        for (uint8_t i = 0; i < scratch.stepCount[lane]; i++) {
+            RecipeStep& step = scratch.steps[lane][i];
+            uint32_t value = getValue(step);
+            step.value = (value > 0xFFFF) ? 0xFFFF : value;
+            step.source = RECIPE_SOURCE_FIXED;
+        }
+    }
+
+    if (preferences.putBytes("recipeC0", &scratch, sizeof(Recipe)) != sizeof(Recipe)) {
+        logger.error("Recipe", "Failed to store custom recipe");
+        return false;
+    }
+    customValid = true;
+    memcpy(customName, scratch.name, RECIPE_NAME_LENGTH);
+    logger.info("Recipe", "Custom recipe saved", customName);
+    return true;
+}
+
+uint8_t RecipeEngine::getStepCount(uint8_t lane) {
+    if (lane >= RECIPE_LANE_COUNT) return 0;
+    return active.stepCount[lane];
+}
+
+const RecipeStep* RecipeEngine::getStep(uint8_t lane, uint8_t index) {
+    if (lane >= RECIPE_LANE_COUNT || index >= active.stepCount[lane]) return nullptr;
+    return &active.steps[lane][index];
+}
+
+uint32_t RecipeEngine::getValue(const RecipeStep& step) {
+    if (step.source != RECIPE_SOURCE_FIXED && step.source < settingCount && settings[step.source]) {
+        int value = *settings[step.source];
+        return (value > 0) ? (uint32_t)value : 0;
+    }
+    return step.value;
+}
+
+uint8_t RecipeEngine::getNextStep(uint8_t lane, uint8_t index) {
+    const RecipeStep* step = getStep(lane, index);
+    return step ? step->next : RECIPE_NEXT_END;
+}
+
+void RecipeEngine::enterStep(uint8_t lane, uint8_t index, bool resumed) {
+    const RecipeStep* step = getStep(lane, index);
+    if (step == nullptr) return;
+
+    skipped[lane] = handlers.skip && handlers.skip(*step);
+    if (skipped[lane]) return;
+
+    applyFrame(step->relays, true);
+    if (!resumed) {
+        frameWaitMs[lane] = 0;
+    }
+    frameLive[lane] = false;
+    frameWaitStart[lane] = millis();
+    if (step->end != RECIPE_END_TIME && handlers.begin) {
+        handlers.begin(*step, getValue(*step), resumed);
+    }
+}
+
+StepResult RecipeEngine::updateStep(uint8_t lane, uint8_t index, unsigned long elapsedMs) {
+    const RecipeStep* step = getStep(lane, index);
+    if (step == nullptr || skipped[lane]) return STEP_DONE;
+
+    StepResult result;
+    if (step->end == RECIPE_END_TIME) {
+        // A load whose start is still queued does not count towards the time
+        if (!frameLive[lane]) {
+            if (isFramePending(step->relays)) return STEP_RUNNING;
+            frameLive[lane] = true;
+            frameWaitMs[lane] += millis() - frameWaitStart[lane];
+        }
+        unsigned long runMs = (elapsedMs > frameWaitMs[lane]) ? elapsedMs - frameWaitMs[lane] : 0;
+        result = (runMs >= getValue(*step) * 1000UL) ? STEP_DONE : STEP_RUNNING;
+    } else {
+        result = handlers.check ? handlers.check(*step, getValue(*step), elapsedMs) : STEP_DONE;
+    }
+
+    if (result == STEP_DONE && handlers.complete) {
+        handlers.complete(*step);
+    }
+    return result;
+}
+
+void RecipeEngine::exitStep(uint8_t lane, uint8_t index) {
+    const RecipeStep* step = getStep(lane, index);
+    if (step == nullptr) return;
+
+    if (skipped[lane]) {
+        skipped[lane] = false;
+        return;
+    }
+
+    applyFrame(step->relays, false);
+    if (step->end != RECIPE_END_TIME && handlers.finish) {
+        handlers.finish(*step);
+    }
+}
+
+unsigned long RecipeEngine::getTimeout(uint8_t lane, uint8_t index) {
+    const RecipeStep* step = getStep(lane, index);
+    if (step == nullptr || skipped[lane]) return 0;
+    return step->timeout * 1000UL;
+}
+
+bool RecipeEngine::isFramePending(uint32_t relays) {
+    if (pendingCheck == nullptr) return false;
+    for (uint8_t i = 0; i < 32 && relays != 0; i++, relays >>= 1) {
+        if ((relays & 1) && pendingCheck(i)) return true;
+    }
+    return false;
+}
+
+void RecipeEngine::applyFrame(uint32_t relays, bool state) {
+    if (relayControl == nullptr) return;
+    for (uint8_t i = 0; i < 32 && relays != 0; i++, relays >>= 1) {
+        if (relays & 1) {
+            relayControl(i, state);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Recipe Engine
+ * Data-driven production recipes and their zero-allocation step executor
+ *
+ * A recipe is a fixed-size table of steps per production lane. Each step
+ * holds the relay frame kept on while it runs, an end condition (time or a
+ * machine condition such as a weighed dose), a timeout and the next step.
+ * Built-in recipes are const tables in flash; one custom recipe is stored
+ * in Preferences. The selected recipe is copied into a static buffer and
+ * interpreted from there - nothing is allocated at run time. A timed step
+ * counts from when its whole frame has actually switched on.
+ */
+
+#ifndef RECIPEENGINE_H
+#define RECIPEENGINE_H
+
+#include <Arduino.h>
+#include <SequencerController.h>
+
+#define RECIPE_FORMAT_VERSION     1
+#define RECIPE_LANE_COUNT         2
+#define RECIPE_MAX_STEPS          10      // Per lane
+#define RECIPE_NAME_LENGTH        12
+#define RECIPE_STEP_NAME_LENGTH   14
+#define RECIPE_NEXT_END           0xFF    // Batch complete, lane starts over
+#define RECIPE_SOURCE_FIXED       0       // Step value used as is
+
+#define RECIPE_RELAY(index)       (1UL << (index))
+
+enum RecipeLane {
+    RECIPE_LANE_PREP,
+    RECIPE_LANE_MOULD
+};
+
+// How a step ends (value is interpreted per condition)
+enum RecipeEnd {
+    RECIPE_END_TIME,          // value = seconds
+    RECIPE_END_WATER,         // value = ml, closed-loop dose
+    RECIPE_END_STARCH,        // value = grams, weighed dispense
+    RECIPE_END_VAT_EMPTY,     // Wait until the vat has been pumped out
+    RECIPE_END_VAT_FULL,      // Wait for prepared pulp
+    RECIPE_END_MOULD,         // value = suction seconds, one moulding cycle
+    RECIPE_END_TRAY,          // Conveyor until the tray has cleared the reject stations
+    RECIPE_END_DRY,           // value = seconds, heater under temperature control
+    RECIPE_END_SHRED,         // value = seconds of forward run, reverses out of jams
+    RECIPE_END_MIX            // value = seconds at most, ends when the load current settles
+};
+
+// Step flags
+#define RECIPE_FLAG_NEW_BATCH     0x01    // Completing this step starts a new batch
+#define RECIPE_FLAG_VAT           0x02    // Works on the vat contents
+#define RECIPE_FLAG_VAT_FILLED    0x04    // Vat full of pulp when the step completes
+#define RECIPE_FLAG_VAT_DRAINED   0x08    // Vat empty when the step completes
+#define RECIPE_FLAG_NEEDS_TRAY    0x10    // Skipped when moulding released no tray
+
+struct RecipeStep {
+    char name[RECIPE_STEP_NAME_LENGTH];
+    uint32_t relays;          // Relay frame held during the step (RECIPE_RELAY bits)
+    uint8_t end;              // RecipeEnd
+    uint8_t source;           // RECIPE_SOURCE_FIXED or a settings table index
+    uint16_t value;
+    uint16_t timeout;         // seconds, 0 = condition default
+    uint8_t next;             // Next step in this lane or RECIPE_NEXT_END
+    uint8_t flags;
+};
+
+struct Recipe {
+    uint8_t version;
+    char name[RECIPE_NAME_LENGTH];
+    uint8_t stepCount[RECIPE_LANE_COUNT];
+    RecipeStep steps[RECIPE_LANE_COUNT][RECIPE_MAX_STEPS];
+};
+
+// Machine side of the executor - everything that is not a relay frame
+struct RecipeHandlers {
+    void (*begin)(const RecipeStep& step, uint32_t value, bool resumed);
+    StepResult (*check)(const RecipeStep& step, uint32_t value, unsigned long elapsedMs);
+    void (*finish)(const RecipeStep& step);           // Step left (done, paused or faulted)
+    void (*complete)(const RecipeStep& step);         // Step finished normally
+    bool (*skip)(const RecipeStep& step);             // nullptr = never skip
+};
+
+class RecipeEngine {
+public:
+    static const uint8_t CUSTOM_SLOT_COUNT = 1;
+
+    RecipeEngine();
+
+    // Initialization - settings[i] is the live value for source i (index 0 unused)
+    void init(const Recipe* builtIns, uint8_t builtInCount, const int* const* settings, uint8_t settingCount,
+              void (*relayControl)(uint8_t relayIndex, bool state), const RecipeHandlers& handlers);
+    // Start of a frame relay still queued (e.g. on the supply budget) - nullptr = switches at once
+    void setPendingCheck(bool (*isPending)(uint8_t relayIndex)) { pendingCheck = isPending; }
+
+    // Selection (persisted)
+    uint8_t getRecipeCount();
+    const char* getRecipeName(uint8_t index);
+    bool select(uint8_t index);
+    uint8_t getSelected() { return selected; }
+    const Recipe& getActive() { return active; }
+
+    // Stores the active recipe with all setting sources resolved to fixed values
+    bool saveActiveAsCustom(const char* name);
+    bool validate(const Recipe& recipe);
+
+    // Executor
+    uint8_t getStepCount(uint8_t lane);
+    const RecipeStep* getStep(uint8_t lane, uint8_t index);
+    uint32_t getValue(const RecipeStep& step);
+    uint8_t getNextStep(uint8_t lane, uint8_t index);
+    void enterStep(uint8_t lane, uint8_t index, bool resumed);
+    StepResult updateStep(uint8_t lane, uint8_t index, unsigned long elapsedMs);
+    void exitStep(uint8_t lane, uint8_t index);
+    unsigned long getTimeout(uint8_t lane, uint8_t index);    // 0 = condition default
+    bool isSkipped(uint8_t lane) { return lane < RECIPE_LANE_COUNT && skipped[lane]; }
+
+private:
+    const Recipe* builtIns;
+    uint8_t builtInCount;
+    const int* const* settings;
+    uint8_t settingCount;
+    void (*relayControl)(uint8_t relayIndex, bool state);
+    bool (*pendingCheck)(uint8_t relayIndex);
+    RecipeHandlers handlers;
+
+    Recipe active;                            // Interpreted copy of the selected recipe
+    Recipe scratch;                           // Custom slot load/save buffer
+    uint8_t selected;
+    bool customValid;
+    char customName[RECIPE_NAME_LENGTH];
+    bool skipped[RECIPE_LANE_COUNT];          // Current step skipped, per lane
+    bool frameLive[RECIPE_LANE_COUNT];        // Timed step's frame has switched on
+    unsigned long frameWaitStart[RECIPE_LANE_COUNT];
+    unsigned long frameWaitMs[RECIPE_LANE_COUNT];   // Step time spent waiting for the frame
+
+    bool loadCustom(Recipe& recipe);
+    void applyFrame(uint32_t relays, bool state);
+    bool isFramePending(uint32_t relays);
+};
+
+#endif // RECIPEENGINE_H
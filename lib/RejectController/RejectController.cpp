@@ -0,0 +1,210 @@
+/*
+ * Reject Controller Implementation
+ */
+
+#include "RejectController.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+RejectController::RejectController() {
+    relayControl = nullptr;
+    conveyorRunning = nullptr;
+    memset(trays, 0, sizeof(trays));
+    head = 0;
+    count = 0;
+    memset(verdicts, 0, sizeof(verdicts));
+    verdictHead = 0;
+    verdictCount = 0;
+    memset(stations, 0, sizeof(stations));
+    lastUpdateUs = 0;
+    passCount = 0;
+    overflowCount = 0;
+}
+
+void RejectController::init(void (*relayCallback)(uint8_t relayIndex, bool state), const bool* conveyorState) {
+    relayControl = relayCallback;
+    conveyorRunning = conveyorState;
+    lastUpdateUs = micros();
+    logger.info("Reject", "Tray tracking initialized");
+}
+
+void RejectController::configureStation(uint8_t station, uint8_t relay, unsigned long distanceMs,
+                                        unsigned long pulseMs, uint8_t defectMask) {
+    if (station >= REJECT_STATION_COUNT) return;
+
+    RejectStation& s = stations[station];
+    if (s.active && s.relay != relay && relayControl) {
+        relayControl(s.relay, false);     // Relay reassigned mid-pulse
+        s.active = false;
+    }
+    s.relay = relay;
+    s.distanceUs = distanceMs * 1000UL;
+    s.pulseMs = pulseMs;
+    s.defectMask = defectMask;
+}
+
+void RejectController::update() {
+    uint32_t now = micros();
+    uint32_t elapsed = now - lastUpdateUs;
+    lastUpdateUs = now;
+
+    // Trays only travel while the conveyor runs
+    if (conveyorRunning && *conveyorRunning && count > 0) {
+        for (uint8_t i = 0; i < count; i++) {
+            TrackedTray& tray = trays[(head + i) % MAX_IN_FLIGHT];
+            tray.positionUs += elapsed;
+
+            if (tray.rejected || tray.defects == DEFECT_NONE) continue;
+
+            // Lowest numbered station whose mask matches takes the tray
+            for (uint8_t s = 0; s < REJECT_STATION_COUNT; s++) {
+                RejectStation& station = stations[s];
+                if ((tray.defects & station.defectMask) == 0) continue;
+                if (tray.positionUs >= station.distanceUs) {
+                    fireStation(s, tray.id);
+                    tray.rejected = true;
+                }
+                break;
+            }
+        }
+
+        // Oldest tray past the last station has left the tracked zone
+        uint32_t lastDistance = lastStationDistance();
+        while (count > 0 && trays[head].positionUs > lastDistance) {
+            if (!trays[head].rejected) {
+                if (trays[head].defects != DEFECT_NONE) {
+                    logger.warning("Reject", "Defective tray passed, no matching station", (int)trays[head].id);
+                }
+                passCount++;
+            }
+            head = (head + 1) % MAX_IN_FLIGHT;
+            count--;
+        }
+    }
+
+    // Release reject relays once their pulse has elapsed
+    unsigned long nowMs = millis();
+    for (uint8_t s = 0; s < REJECT_STATION_COUNT; s++) {
+        RejectStation& station = stations[s];
+        if (station.active && (long)(nowMs - station.offTime) >= 0) {
+            station.active = false;
+            if (relayControl) {
+                relayControl(station.relay, false);
+            }
+        }
+    }
+}
+
+void RejectController::fireStation(uint8_t station, uint32_t trayId) {
+    RejectStation& s = stations[station];
+
+    // Back-to-back rejects extend the pulse instead of chattering the relay
+    s.offTime = millis() + s.pulseMs;
+    if (!s.active) {
+        s.active = true;
+        if (relayControl) {
+            relayControl(s.relay, true);
+        }
+    }
+    s.rejectCount++;
+    logger.info("Reject", "Tray rejected", (int)trayId);
+}
+
+void RejectController::onTrayDetected(uint32_t trayId, uint32_t leadingEdgeUs) {
+    if (count >= MAX_IN_FLIGHT) {
+        dropOldest();
+    }
+
+    TrackedTray& tray = trays[(head + count) % MAX_IN_FLIGHT];
+    tray.id = trayId;
+    tray.rejected = false;
+
+    // Credit the travel since the ISR edge so loop latency does not shift the reject point
+    uint32_t now = micros();
+    tray.positionUs = (conveyorRunning && *conveyorRunning) ? now - leadingEdgeUs : 0;
+
+    // Oldest queued verdict belongs to this tray
+    if (verdictCount > 0) {
+        tray.defects = verdicts[verdictHead];
+        verdictHead = (verdictHead + 1) % VERDICT_QUEUE_SIZE;
+        verdictCount--;
+    } else {
+        tray.defects = DEFECT_NONE;
+    }
+    count++;
+
+    if (tray.defects != DEFECT_NONE) {
+        logger.debug("Reject", "Defective tray tracked", (int)trayId);
+    }
+}
+
+void RejectController::queueVerdict(uint8_t defects) {
+    if (verdictCount >= VERDICT_QUEUE_SIZE) {
+        // More verdicts than trays - oldest verdict has no tray
+        verdictHead = (verdictHead + 1) % VERDICT_QUEUE_SIZE;
+        verdictCount--;
+        logger.warning("Reject", "Verdict queue overflow");
+    }
+    verdicts[(verdictHead + verdictCount) % VERDICT_QUEUE_SIZE] = defects;
+    verdictCount++;
+}
+
+bool RejectController::withdrawVerdict() {
+    if (verdictCount == 0) return false;
+    verdictCount--;
+    return true;
+}
+
+bool RejectController::tagTray(uint32_t trayId, uint8_t defects) {
+    for (uint8_t i = 0; i < count; i++) {
+        TrackedTray& tray = trays[(head + i) % MAX_IN_FLIGHT];
+        if (tray.id == trayId) {
+            tray.defects |= defects;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RejectController::clear() {
+    head = 0;
+    count = 0;
+    verdictHead = 0;
+    verdictCount = 0;
+    for (uint8_t s = 0; s < REJECT_STATION_COUNT; s++) {
+        if (stations[s].active && relayControl) {
+            relayControl(stations[s].relay, false);
+        }
+        stations[s].active = false;
+    }
+}
+
+void RejectController::dropOldest() {
+    overflowCount++;
+    logger.warning("Reject", "Tracking queue full, dropping tray", (int)trays[head].id);
+    head = (head + 1) % MAX_IN_FLIGHT;
+    count--;
+}
+
+uint32_t RejectController::lastStationDistance() {
+    uint32_t distance = 0;
+    for (uint8_t s = 0; s < REJECT_STATION_COUNT; s++) {
+        if (stations[s].distanceUs > distance) {
+            distance = stations[s].distanceUs;
+        }
+    }
+    return distance;
+}
+
+uint32_t RejectController::getRejectCount(uint8_t station) {
+    if (station >= REJECT_STATION_COUNT) return 0;
+    return stations[station].rejectCount;
+}
+
+void RejectController::logStatistics() {
+    logger.debug("Reject", "Trays in flight", (int)count);
+    logger.debug("Reject", "Rejected (station 1)", (int)stations[0].rejectCount);
+    logger.debug("Reject", "Rejected (station 2)", (int)stations[1].rejectCount);
+    logger.debug("Reject", "Passed", (int)passCount);
+}
@@ -0,0 +1,99 @@
+/*
+ * Reject Controller
+ * Conveyor tray tracking queue driving the defect reject relays
+ *
+ * Each tray seen by the IR sensor enters the queue with its quality
+ * verdict and is advanced by conveyor run time. When it reaches a reject
+ * station whose defect mask matches, that station's relay is pulsed.
+ */
+
+#ifndef REJECTCONTROLLER_H
+#define REJECTCONTROLLER_H
+
+#include <Arduino.h>
+
+// Defect flags (a tray can carry several)
+#define DEFECT_NONE            0x00
+#define DEFECT_STARCH_WEIGHT   0x01   // Starch dose out of tolerance
+#define DEFECT_WATER_DOSE      0x02   // Water dose out of tolerance
+#define DEFECT_MOULD_FAULT     0x04   // Suction / blow phase fault
+#define DEFECT_DRYING          0x08   // Drying temperature fault
+#define DEFECT_OTHER           0x80
+
+#define REJECT_STATION_COUNT   2
+
+// One tray in flight between the IR sensor and the last reject station
+struct TrackedTray {
+    uint32_t id;                  // Tray count at detection
+    uint32_t positionUs;          // Conveyor run time since the leading edge
+    uint8_t defects;
+    bool rejected;
+};
+
+// Reject station: relay, distance from the IR sensor (conveyor run time) and pulse
+struct RejectStation {
+    uint8_t relay;
+    uint32_t distanceUs;
+    unsigned long pulseMs;
+    uint8_t defectMask;           // Defects this station rejects
+    bool active;
+    unsigned long offTime;
+    uint32_t rejectCount;
+};
+
+class RejectController {
+public:
+    static const uint8_t MAX_IN_FLIGHT = 16;
+    static const uint8_t VERDICT_QUEUE_SIZE = 8;
+
+    RejectController();
+
+    // Initialization - relayControl drives the reject relays (setRelay),
+    // conveyorRunning points at the live conveyor relay state
+    void init(void (*relayControl)(uint8_t relayIndex, bool state), const bool* conveyorRunning);
+    void configureStation(uint8_t station, uint8_t relay, unsigned long distanceMs,
+                          unsigned long pulseMs, uint8_t defectMask);
+
+    // Advance trays and fire/release relays (call in loop)
+    void update();
+
+    // Tray entry (call on the IR sensor leading edge, with its ISR timestamp)
+    void onTrayDetected(uint32_t trayId, uint32_t leadingEdgeUs);
+
+    // Verdicts - queued for the next tray to arrive, or tagged on a tray in flight
+    void queueVerdict(uint8_t defects);
+    bool tagTray(uint32_t trayId, uint8_t defects);
+    bool withdrawVerdict();       // Newest queued verdict - its tray never reached the sensor
+
+    void clear();
+
+    // Status
+    uint8_t getInFlightCount() { return count; }
+    uint32_t getRejectCount(uint8_t station);
+    uint32_t getPassCount() { return passCount; }
+    uint32_t getOverflowCount() { return overflowCount; }
+    void logStatistics();
+
+private:
+    void (*relayControl)(uint8_t relayIndex, bool state);
+    const bool* conveyorRunning;
+
+    TrackedTray trays[MAX_IN_FLIGHT];
+    uint8_t head;                 // Oldest tray
+    uint8_t count;
+
+    uint8_t verdicts[VERDICT_QUEUE_SIZE];
+    uint8_t verdictHead;
+    uint8_t verdictCount;
+
+    RejectStation stations[REJECT_STATION_COUNT];
+    uint32_t lastUpdateUs;
+    uint32_t passCount;
+    uint32_t overflowCount;
+
+    uint32_t lastStationDistance();
+    void fireStation(uint8_t station, uint32_t trayId);
+    void dropOldest();
+};
+
+#endif // REJECTCONTROLLER_H
@@ -0,0 +1,121 @@
+/*
+ * HX711 Scale Backend Implementation
+ */
+
+#include "HX711Backend.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+HX711Backend* HX711Backend::instance = nullptr;
+
+HX711Backend::HX711Backend() {
+    doutPin = 255;
+    sckPin = 255;
+    hardwareRate = 10;
+    gainPulses = HX711_GAIN_A128;
+    head = 0;
+    tail = 0;
+    overruns = 0;
+    mux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+void HX711Backend::configure(uint8_t dout, uint8_t sck, uint16_t rate) {
+    doutPin = dout;
+    sckPin = sck;
+    hardwareRate = rate;
+}
+
+bool HX711Backend::begin() {
+    if (doutPin == 255 || sckPin == 255) {
+        return false;
+    }
+
+    pinMode(sckPin, OUTPUT);
+    digitalWrite(sckPin, LOW);          // SCK high > 60us powers the chip down
+    pinMode(doutPin, INPUT_PULLUP);
+
+    // Probe: a connected HX711 pulls DOUT low within one conversion period
+    unsigned long start = millis();
+    unsigned long timeout = 2000UL / hardwareRate + 100;
+    while (digitalRead(doutPin) == HIGH) {
+        if (millis() - start > timeout) {
+            return false;
+        }
+        delay(1);
+    }
+
+    head = 0;
+    tail = 0;
+    overruns = 0;
+    instance = this;
+    attachInterrupt(digitalPinToInterrupt(doutPin), dataReadyISR, FALLING);
+    return true;
+}
+
+void IRAM_ATTR HX711Backend::dataReadyISR() {
+    if (instance) {
+        instance->shiftIn();
+    }
+}
+
+void IRAM_ATTR HX711Backend::shiftIn() {
+    // Edges produced while shifting re-trigger the interrupt; DOUT is
+    // high again once the conversion has been read, so those return here
+    if (digitalRead(doutPin) != LOW) {
+        return;
+    }
+
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < 24; i++) {
+        digitalWrite(sckPin, HIGH);
+        delayMicroseconds(1);
+        value = (value << 1) | (digitalRead(doutPin) ? 1 : 0);
+        digitalWrite(sckPin, LOW);
+        delayMicroseconds(1);
+    }
+
+    // Extra pulses select channel/gain for the next conversion
+    for (uint8_t i = 0; i < gainPulses; i++) {
+        digitalWrite(sckPin, HIGH);
+        delayMicroseconds(1);
+        digitalWrite(sckPin, LOW);
+        delayMicroseconds(1);
+    }
+
+    // Sign-extend 24-bit two's complement
+    int32_t sample = (int32_t)(value << 8) >> 8;
+
+    portENTER_CRITICAL_ISR(&mux);
+    uint8_t next = (head + 1) % BUFFER_SIZE;
+    if (next == tail) {
+        // Loop fell behind - drop the oldest sample
+        tail = (tail + 1) % BUFFER_SIZE;
+        overruns++;
+    }
+    buffer[head] = sample;
+    head = next;
+    portEXIT_CRITICAL_ISR(&mux);
+}
+
+bool HX711Backend::available() {
+    return head != tail;
+}
+
+int32_t HX711Backend::read() {
+    int32_t sample = 0;
+
+    portENTER_CRITICAL(&mux);
+    if (head != tail) {
+        sample = buffer[tail];
+        tail = (tail + 1) % BUFFER_SIZE;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return sample;
+}
+
+void HX711Backend::setGain(uint8_t pulses) {
+    if (pulses < 1 || pulses > 3) return;
+    gainPulses = pulses;
+}
@@ -0,0 +1,60 @@
+/*
+ * HX711 Scale Backend
+ * Interrupt driven: DOUT falling edge (data ready) triggers an ISR that
+ * clocks out the conversion into a ring buffer, so the loop never
+ * busy-waits or bit-bangs.
+ *
+ * Rate is fixed by the board's RATE pin (10 or 80 SPS).
+ */
+
+#ifndef HX711BACKEND_H
+#define HX711BACKEND_H
+
+#include <Arduino.h>
+#include "ScaleBackend.h"
+
+// Gain / channel selection: extra SCK pulses after the 24 data bits
+#define HX711_GAIN_A128 1   // Channel A, gain 128
+#define HX711_GAIN_B32  2   // Channel B, gain 32
+#define HX711_GAIN_A64  3   // Channel A, gain 64
+
+class HX711Backend : public ScaleBackend {
+public:
+    static const uint8_t BUFFER_SIZE = 16;
+
+    HX711Backend();
+
+    // Pins and the hardware rate (RATE pin low = 10 SPS, high = 80 SPS)
+    void configure(uint8_t doutPin, uint8_t sckPin, uint16_t hardwareRate = 10);
+
+    bool begin() override;
+    const char* getName() override { return "HX711"; }
+
+    bool available() override;
+    int32_t read() override;
+
+    uint16_t setRate(uint16_t /*sps*/, bool /*recalibrate*/) override { return hardwareRate; }
+    uint16_t getSupportedRate(uint16_t /*sps*/) override { return hardwareRate; }
+
+    void setGain(uint8_t gainPulses);        // Takes effect from the next conversion
+    uint32_t getOverruns() { return overruns; }
+
+private:
+    uint8_t doutPin;
+    uint8_t sckPin;
+    uint16_t hardwareRate;
+    volatile uint8_t gainPulses;
+
+    // ISR -> loop ring buffer
+    volatile int32_t buffer[BUFFER_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint32_t overruns;
+    portMUX_TYPE mux;
+
+    static HX711Backend* instance;           // Single HX711 per machine
+    static void IRAM_ATTR dataReadyISR();
+    void IRAM_ATTR shiftIn();
+};
+
+#endif // HX711BACKEND_H
@@ -0,0 +1,108 @@
+/*
+ * NAU7802 Scale Backend Implementation
+ */
+
+#include "NAU7802Backend.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+NAU7802Backend::NAU7802Backend() {
+    afeCalibrating = false;
+    channel2Enabled = false;
+}
+
+bool NAU7802Backend::begin() {
+    if (scale.begin() == false) {
+        return false;
+    }
+
+    scale.setGain(NAU7802_GAIN_128);      // Gain of 128
+    scale.setSampleRate(NAU7802_SPS_80);
+    scale.calibrateAFE();                 // Calibrate analog front end
+    afeCalibrating = false;
+    return true;
+}
+
+bool NAU7802Backend::available() {
+    return scale.available();
+}
+
+int32_t NAU7802Backend::read() {
+    return scale.getReading();
+}
+
+uint16_t NAU7802Backend::getSupportedRate(uint16_t sps) {
+    if (sps >= 320) return 320;
+    if (sps >= 80)  return 80;
+    if (sps >= 40)  return 40;
+    if (sps >= 20)  return 20;
+    return 10;
+}
+
+uint16_t NAU7802Backend::setRate(uint16_t sps, bool recalibrate) {
+    uint16_t actual = getSupportedRate(sps);
+    uint8_t code;
+
+    switch (actual) {
+        case 320: code = NAU7802_SPS_320; break;
+        case 80:  code = NAU7802_SPS_80;  break;
+        case 40:  code = NAU7802_SPS_40;  break;
+        case 20:  code = NAU7802_SPS_20;  break;
+        default:  code = NAU7802_SPS_10;  break;
+    }
+
+    scale.setSampleRate(code);
+
+    // Offset/gain calibration is rate dependent; run it without blocking.
+    // Quick switches keep the old calibration until the next recalibrating one.
+    if (recalibrate) {
+        scale.beginCalibrateAFE();
+        afeCalibrating = true;
+    }
+    return actual;
+}
+
+bool NAU7802Backend::setChannel(uint8_t channel) {
+    if (channel > 1) return false;
+
+    if (channel == 1 && !channel2Enabled) {
+        // begin() parks the PGA decoupling capacitor on the channel 2 pins
+        scale.clearBit(NAU7802_PGA_PWR_PGA_CAP_EN, NAU7802_POWER);
+        channel2Enabled = true;
+    }
+    return scale.setChannel(channel == 0 ? NAU7802_CHANNEL_1 : NAU7802_CHANNEL_2);
+}
+
+bool NAU7802Backend::isBusy() {
+    if (!afeCalibrating) return false;
+
+    int status = scale.calAFEStatus();
+    if (status == NAU7802_CAL_IN_PROGRESS) {
+        return true;
+    }
+    if (status == NAU7802_CAL_FAILURE) {
+        logger.warning("Scale", "AFE calibration failed");
+    }
+    afeCalibrating = false;
+    return false;
+}
+
+void NAU7802Backend::beginTemperatureRead() {
+    // Route the internal sensor to the ADC at unity gain (it would clip at 128)
+    scale.setGain(NAU7802_GAIN_1);
+    scale.setBit(NAU7802_I2C_CONTROL_TS, NAU7802_I2C_CONTROL);
+}
+
+float NAU7802Backend::endTemperatureRead(int32_t raw) {
+    scale.clearBit(NAU7802_I2C_CONTROL_TS, NAU7802_I2C_CONTROL);
+    scale.setGain(NAU7802_GAIN_128);
+
+    // The offset calibration belongs to the gain it ran at; redo it for 128
+    scale.beginCalibrateAFE();
+    afeCalibrating = true;
+
+    // Sensor: ~109 mV at 25 C, ~360 uV/C; full scale is +/- VREF/2 at gain 1
+    float volts = raw * (NAU7802_TEMP_VREF / 2.0f) / 8388608.0f;
+    return 25.0f + (volts - 0.109f) / 0.00036f;
+}
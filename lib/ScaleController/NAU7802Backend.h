@@ -0,0 +1,45 @@
+/*
+ * NAU7802 Scale Backend
+ * SparkFun Qwiic Scale (I2C, 24-bit, 10-320 SPS, internal temperature sensor)
+ */
+
+#ifndef NAU7802BACKEND_H
+#define NAU7802BACKEND_H
+
+#include <Arduino.h>
+#include <SparkFun_Qwiic_Scale_NAU7802_Arduino_Library.h>
+#include "ScaleBackend.h"
+
+// NAU7802 reference voltage (LDO set to 3.3V by the library) for temperature conversion
+#define NAU7802_TEMP_VREF 3.3f
+
+class NAU7802Backend : public ScaleBackend {
+public:
+    NAU7802Backend();
+
+    bool begin() override;
+    const char* getName() override { return "NAU7802"; }
+
+    bool available() override;
+    int32_t read() override;
+
+    uint16_t setRate(uint16_t sps, bool recalibrate) override;
+    uint16_t getSupportedRate(uint16_t sps) override;
+    bool isBusy() override;
+
+    uint8_t getChannelCount() override { return 2; }
+    bool setChannel(uint8_t channel) override;
+
+    bool hasTemperatureSensor() override { return true; }
+    void beginTemperatureRead() override;
+    float endTemperatureRead(int32_t raw) override;
+
+    NAU7802& getDevice() { return scale; }
+
+private:
+    NAU7802 scale;
+    bool afeCalibrating;
+    bool channel2Enabled;       // PGA bypass capacitor removed from VIN2
+};
+
+#endif // NAU7802BACKEND_H
@@ -0,0 +1,41 @@
+/*
+ * Scale Backend
+ * Interface between ScaleController and a load cell ADC chip
+ *
+ * Backends deliver raw signed counts; filtering, calibration and rate
+ * profiles live in ScaleController so every chip feeds the same stream.
+ */
+
+#ifndef SCALEBACKEND_H
+#define SCALEBACKEND_H
+
+#include <Arduino.h>
+
+class ScaleBackend {
+public:
+    virtual ~ScaleBackend() {}
+
+    virtual bool begin() = 0;
+    virtual const char* getName() = 0;
+
+    // Sample stream
+    virtual bool available() = 0;            // New conversion ready
+    virtual int32_t read() = 0;              // Signed raw counts
+
+    // Rate control - backends pick the nearest supported rate and return it.
+    // recalibrate=false skips any internal calibration for a quick switch.
+    virtual uint16_t setRate(uint16_t sps, bool recalibrate) = 0;
+    virtual uint16_t getSupportedRate(uint16_t sps) { return sps; }  // Rate setRate() would pick
+    virtual bool isBusy() { return false; }  // Internal calibration after a rate/gain change
+
+    // Input multiplexer - conversions after a switch need settling discards
+    virtual uint8_t getChannelCount() { return 1; }
+    virtual bool setChannel(uint8_t channel) { return channel == 0; }
+
+    // Optional internal temperature sensor (conversion replaces one load sample)
+    virtual bool hasTemperatureSensor() { return false; }
+    virtual void beginTemperatureRead() {}
+    virtual float endTemperatureRead(int32_t /*raw*/) { return NAN; }
+};
+
+#endif // SCALEBACKEND_H
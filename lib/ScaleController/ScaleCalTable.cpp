@@ -0,0 +1,135 @@
+/*
+ * Scale Calibration Table Implementation
+ */
+
+#include "ScaleCalTable.h"
+
+ScaleCalTable::ScaleCalTable() {
+    clear();
+}
+
+void ScaleCalTable::clear() {
+    count = 1;
+    raw[0] = 0;
+    grams[0] = 0;
+    rebuild();
+}
+
+void ScaleCalTable::setLinear(int32_t rawSpan, float weight) {
+    clear();
+    addPoint(rawSpan, weight);
+}
+
+bool ScaleCalTable::addPoint(int32_t rawValue, float weight) {
+    if (rawValue == 0 || weight <= 0) {
+        return false;
+    }
+
+    // Same reference weight again - replace the old reading
+    for (uint8_t i = 0; i < count; i++) {
+        if (fabs(grams[i] - weight) < 0.01f) {
+            raw[i] = rawValue;
+            rebuild();
+            return true;
+        }
+    }
+
+    if (count >= MAX_POINTS) {
+        return false;
+    }
+
+    raw[count] = rawValue;
+    grams[count] = weight;
+    count++;
+    rebuild();
+    return true;
+}
+
+void ScaleCalTable::rebuild() {
+    // Insertion sort by raw value (at most 8 points)
+    for (uint8_t i = 1; i < count; i++) {
+        int32_t r = raw[i];
+        float g = grams[i];
+        int8_t j = i - 1;
+        while (j >= 0 && raw[j] > r) {
+            raw[j + 1] = raw[j];
+            grams[j + 1] = grams[j];
+            j--;
+        }
+        raw[j + 1] = r;
+        grams[j + 1] = g;
+    }
+
+    // Segment slopes; the last point keeps the last segment's slope for extrapolation
+    for (uint8_t i = 0; i + 1 < count; i++) {
+        int32_t dr = raw[i + 1] - raw[i];
+        slope[i] = (dr != 0) ? (grams[i + 1] - grams[i]) / (float)dr : 0;
+    }
+    slope[count - 1] = (count >= 2) ? slope[count - 2] : 0;
+
+    // Pad so the search never selects an unused entry
+    for (uint8_t i = count; i < MAX_POINTS; i++) {
+        raw[i] = INT32_MAX;
+        grams[i] = grams[count - 1];
+        slope[i] = slope[count - 1];
+    }
+}
+
+float ScaleCalTable::evaluate(int32_t x) const {
+    // Largest i with raw[i] <= x (or 0 below the first point)
+    uint8_t i = 0;
+    i += (x >= raw[i + 4]) ? 4 : 0;
+    i += (x >= raw[i + 2]) ? 2 : 0;
+    i += (x >= raw[i + 1]) ? 1 : 0;
+
+    return grams[i] + (float)(x - raw[i]) * slope[i];
+}
+
+float ScaleCalTable::getCountsPerGram() const {
+    if (!isValid()) {
+        return 1.0;
+    }
+    float dg = grams[count - 1] - grams[0];
+    return (dg != 0) ? (raw[count - 1] - raw[0]) / dg : 1.0;
+}
+
+size_t ScaleCalTable::serialize(uint8_t* buffer, size_t size) const {
+    if (size < storageSize()) {
+        return 0;
+    }
+
+    buffer[0] = VERSION;
+    buffer[1] = count;
+    uint8_t* p = buffer + 2;
+    for (uint8_t i = 0; i < MAX_POINTS; i++) {
+        memcpy(p, &raw[i], 4);
+        memcpy(p + 4, &grams[i], 4);
+        p += 8;
+    }
+    return storageSize();
+}
+
+bool ScaleCalTable::deserialize(const uint8_t* buffer, size_t size) {
+    if (size < storageSize() || buffer[0] != VERSION) {
+        return false;
+    }
+
+    uint8_t n = buffer[1];
+    if (n < 1 || n > MAX_POINTS) {
+        return false;
+    }
+
+    const uint8_t* p = buffer + 2;
+    for (uint8_t i = 0; i < n; i++) {
+        memcpy(&raw[i], p, 4);
+        memcpy(&grams[i], p + 4, 4);
+        if (isnan(grams[i])) {
+            clear();
+            return false;
+        }
+        p += 8;
+    }
+    count = n;
+    rebuild();
+    return true;
+}
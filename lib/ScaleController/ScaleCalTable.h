@@ -0,0 +1,48 @@
+/*
+ * Scale Calibration Table
+ * N-point piecewise-linear load cell calibration (raw counts above zero -> grams)
+ *
+ * Fixed size, padded with INT32_MAX so evaluation is a 3-step unrolled
+ * binary search with no loop and no bounds checks.
+ */
+
+#ifndef SCALECALTABLE_H
+#define SCALECALTABLE_H
+
+#include <Arduino.h>
+
+class ScaleCalTable {
+public:
+    static const uint8_t MAX_POINTS = 8;     // Must stay 8 for the unrolled search
+    static const uint8_t VERSION = 1;        // Bump when the stored layout changes
+
+    ScaleCalTable();
+
+    void clear();                            // Only the (0, 0) origin point
+    void setLinear(int32_t rawSpan, float grams);
+    bool addPoint(int32_t raw, float grams); // Insert or replace (same weight)
+
+    // raw is counts relative to the zero offset
+    float evaluate(int32_t raw) const;
+
+    bool isValid() const { return count >= 2; }
+    uint8_t getCount() const { return count; }
+    int32_t getRaw(uint8_t i) const { return raw[i]; }
+    float getGrams(uint8_t i) const { return grams[i]; }
+    float getCountsPerGram() const;          // Average sensitivity (legacy factor)
+
+    // Flat storage for Preferences
+    size_t serialize(uint8_t* buffer, size_t size) const;
+    bool deserialize(const uint8_t* buffer, size_t size);
+    static size_t storageSize() { return 2 + MAX_POINTS * 8; }
+
+private:
+    uint8_t count;
+    int32_t raw[MAX_POINTS];                 // Ascending, unused = INT32_MAX
+    float grams[MAX_POINTS];
+    float slope[MAX_POINTS];                 // grams per count from point i onward
+
+    void rebuild();
+};
+
+#endif // SCALECALTABLE_H
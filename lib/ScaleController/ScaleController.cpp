@@ -1,6 +1,6 @@
 /*
  * Scale Controller Implementation
- * Manages NAU7802 24-bit ADC for load cell weight measurements
+ * Load cell weight measurements through a pluggable ADC backend (NAU7802 / HX711)
  */
 
 #include "ScaleController.h"
@@ -10,34 +10,136 @@
 extern Preferences preferences;
 extern LogController logger;
 
+// Profile table - faster rates get a wider median and a quicker Kalman stage
+static const ScaleRateProfileConfig rateProfiles[SCALE_PROFILE_COUNT] = {
+    // name       sps  discard  median  stage                IIR  Q    R     gate  band
+    {"Precision", 10,  2,      {3,      FILTER_STAGE_KALMAN, 3,   1,   200,  4,    30}},
+    {"Rest",      40,  3,      {5,      FILTER_STAGE_KALMAN, 3,   2,   300,  4,    40}},
+    {"Normal",    80,  4,      {5,      FILTER_STAGE_KALMAN, 3,   4,   400,  4,    50}},
+    {"Fast",      320, 8,      {5,      FILTER_STAGE_KALMAN, 3,   32,  900,  4,    80}}
+};
+
+// Tank channel only sees short bursts - light median, slow drift model
+static const SignalFilterConfig tankFilterConfig = {3, FILTER_STAGE_KALMAN, 3, 8, 400, 4, 80};
+
+const ScaleRateProfileConfig& ScaleController::getProfileConfig(ScaleRateProfile profile) {
+    if (profile >= SCALE_PROFILE_COUNT) {
+        profile = SCALE_PROFILE_NORMAL;
+    }
+    return rateProfiles[profile];
+}
+
+const ScaleRateProfileConfig& ScaleController::getRateConfig() {
+    // Fixed or coarse rate backends may not run the requested rate - tune
+    // the filter and discards for the nearest profile to what they deliver
+    uint8_t best = 0;
+    for (uint8_t i = 1; i < SCALE_PROFILE_COUNT; i++) {
+        if (abs((int)rateProfiles[i].sps - (int)activeRate) <
+            abs((int)rateProfiles[best].sps - (int)activeRate)) {
+            best = i;
+        }
+    }
+    return rateProfiles[best];
+}
+
 ScaleController::ScaleController() {
     zeroOffset = 0;
     calibrationFactor = 1.0;
     calibrated = false;
     connected = false;
+    lastRaw = 0;
+    lastFiltered = 0;
+    rateWindowStart = 0;
+    rateWindowSamples = 0;
+    measuredRate = 0;
+    backend = nullptr;
+    activeProfile = SCALE_PROFILE_NORMAL;
+    activeRate = rateProfiles[SCALE_PROFILE_NORMAL].sps;
+    autoRate = false;
+    rateSwitching = false;
+    discardRemaining = 0;
+    lastMotionTime = 0;
+    settleTimeoutMs = DEFAULT_SETTLE_TIMEOUT;
+    settleDetector.configure((uint32_t)DEFAULT_SETTLE_NOISE * DEFAULT_SETTLE_NOISE, DEFAULT_SETTLE_HOLD);
+    memset(&lastCalResult, 0, sizeof(lastCalResult));
+    calState = SCALE_CAL_IDLE;
+    calChannel = SCALE_CHANNEL_STARCH;
+    calTarget = 0;
+    calAddPoint = false;
+    calStartTime = 0;
+    tempCompEnabled = false;
+    tempPending = false;
+    hasTemperature = false;
+    temperatureC = 0;
+    lastTempRead = 0;
+    zeroTemperature = NAN;
+    spanTemperature = NAN;
+    zeroTempCoeff = 0;
+    spanTempCoeff = 0;
+    tareGrams = 0;
+    dispenseActive = false;
+    calibratedZero = 0;
+    zeroTrackEnabled = false;
+    zeroTrackBand = 2.0;
+    zeroTrackLimit = 20.0;
+    zeroTrackSince = 0;
+    lastZeroTrack = 0;
+    tank.zeroOffset = 0;
+    tank.calibrationFactor = 1.0;
+    tank.calibrated = false;
+    tank.lastRaw = 0;
+    tank.lastFiltered = 0;
+    tank.lastSampleTime = 0;
+    tankEnabled = false;
+    activeChannel = SCALE_CHANNEL_STARCH;
+    burstRemaining = 0;
+    tankInterval = DEFAULT_TANK_INTERVAL;
+    lastTankBurst = 0;
+    tankWindowSamples = 0;
+    measuredTankRate = 0;
+    resyncFilter = false;
+    tank.filter.configure(tankFilterConfig);
+    
+    // Default chain: 5-sample median spike filter into adaptive Kalman
+    filter.configure(rateProfiles[SCALE_PROFILE_NORMAL].filter);
 }
 
-bool ScaleController::init() {
+bool ScaleController::init(uint8_t hx711DoutPin, uint8_t hx711SckPin, uint16_t hx711Rate) {
     logger.info("Scale", "Initializing NAU7802...");
     
-    // Initialize NAU7802
-    if (scale.begin() == false) {
-        logger.error("Scale", "NAU7802 not detected!");
+    // Prefer the NAU7802 on I2C, fall back to an HX711 board if fitted
+    if (nauBackend.begin()) {
+        backend = &nauBackend;
+    } else {
+        logger.warning("Scale", "NAU7802 not detected, trying HX711...");
+        hxBackend.configure(hx711DoutPin, hx711SckPin, hx711Rate);
+        if (hxBackend.begin()) {
+            backend = &hxBackend;
+        }
+    }
+    
+    if (backend == nullptr) {
+        logger.error("Scale", "No load cell ADC detected!");
         connected = false;
         return false;
     }
     
     connected = true;
-    logger.info("Scale", "NAU7802 detected");
+    logger.info("Scale", "ADC detected", backend->getName());
     
-    // Configure scale
-    scale.setSampleRate(NAU7802_SPS_80);  // 80 samples per second
-    scale.setGain(NAU7802_GAIN_128);      // Gain of 128
-    scale.calibrateAFE();                 // Calibrate analog front end
+    // Configure sample rate for the starting profile
+    activeRate = backend->setRate(rateProfiles[activeProfile].sps, true);
+    rateSwitching = true;
+    filter.configure(getRateConfig().filter);
+    discardRemaining = getRateConfig().discardSamples;
     
     // Load saved calibration
     loadCalibration();
     
+    filter.reset();
+    rateWindowStart = millis();
+    rateWindowSamples = 0;
+    
     logger.info("Scale", calibrated ? "Calibrated" : "Not calibrated");
     
     return true;
@@ -48,37 +150,33 @@ void ScaleController::startCalibration() {
     calibrated = false;
 }
 
-bool ScaleController::calibrateZero() {
+void ScaleController::setSettleCriteria(uint16_t maxNoiseCounts, uint8_t holdSamples, unsigned long timeoutMs) {
+    settleDetector.configure((uint32_t)maxNoiseCounts * maxNoiseCounts, holdSamples);
+    settleTimeoutMs = timeoutMs;
+}
+
+bool ScaleController::beginZeroCalibration(ScaleChannel channel) {
     if (!connected) {
         logger.error("Scale", "Not connected!");
         return false;
     }
     
-    logger.info("Scale", "Calibrating zero...");
-    
-    // Wait for scale to be ready
-    delay(500);
-    
-    // Take average of multiple readings
-    long sum = 0;
-    const int samples = 10;
-    
-    for (int i = 0; i < samples; i++) {
-        while (!scale.available()) {
-            delay(1);
-        }
-        sum += scale.getReading();
-        delay(50);
+    if (channel == SCALE_CHANNEL_TANK && (!tankEnabled || backend->getChannelCount() < 2)) {
+        logger.error("Scale", "Tank channel not available!");
+        return false;
     }
     
-    zeroOffset = sum / (float)samples;
-    
-    logger.info("Scale", "Zero calibration complete");
+    logger.info("Scale", "Calibrating zero...");
     
+    calChannel = channel;
+    calTarget = 0;
+    calState = SCALE_CAL_MEASURING;
+    calStartTime = millis();
+    settleDetector.reset();
     return true;
 }
 
-bool ScaleController::calibrateKnownWeight(float knownWeight) {
+bool ScaleController::beginWeightCalibration(float knownWeight, ScaleChannel channel) {
     if (!connected) {
         logger.error("Scale", "Not connected!");
         return false;
@@ -89,36 +187,153 @@ bool ScaleController::calibrateKnownWeight(float knownWeight) {
         return false;
     }
     
+    if (channel == SCALE_CHANNEL_TANK && (!tankEnabled || backend->getChannelCount() < 2)) {
+        logger.error("Scale", "Tank channel not available!");
+        return false;
+    }
+    
     logger.info("Scale", "Starting weight calibration...");
     
-    // Wait for scale to be ready
-    delay(500);
+    calChannel = channel;
+    calTarget = knownWeight;
+    calAddPoint = false;
+    calState = SCALE_CAL_MEASURING;
+    calStartTime = millis();
+    settleDetector.reset();
+    return true;
+}
+
+bool ScaleController::beginPointCalibration(float knownWeight) {
+    if (!calibrated) {
+        // First point defines the table - same as a plain weight calibration
+        return beginWeightCalibration(knownWeight);
+    }
+    
+    if (!beginWeightCalibration(knownWeight)) {
+        return false;
+    }
+    
+    logger.info("Scale", "Adding calibration point");
+    calAddPoint = true;
+    return true;
+}
+
+void ScaleController::cancelCalibration() {
+    if (calState != SCALE_CAL_MEASURING) return;
+    
+    calState = SCALE_CAL_IDLE;
+    logger.warning("Scale", "Calibration cancelled");
+}
+
+uint8_t ScaleController::getCalibrationProgress() {
+    if (calState != SCALE_CAL_MEASURING) {
+        return (calState == SCALE_CAL_DONE) ? 100 : 0;
+    }
+    
+    // Whichever is further along: stability progress or elapsed timeout
+    uint8_t settle = settleDetector.getProgress();
+    uint8_t timeout = (uint8_t)((millis() - calStartTime) * 100UL / settleTimeoutMs);
+    if (timeout > 99) timeout = 99;
+    return (settle > timeout) ? settle : timeout;
+}
+
+void ScaleController::updateCalibration(bool newSample) {
+    if (newSample) {
+        settleDetector.add(calChannel == SCALE_CHANNEL_TANK ? tank.lastFiltered : lastFiltered);
+    }
+    
+    bool timedOut = (millis() - calStartTime >= settleTimeoutMs);
+    if (!settleDetector.isStable() && !timedOut) {
+        return;
+    }
+    
+    // Record the settled measurement
+    ScaleCalibrationResult& result = lastCalResult;
+    result.stable = settleDetector.isStable();
+    result.mean = settleDetector.getMean();
+    result.noise = SignalFilter::isqrt(settleDetector.getVariance());
+    result.samples = settleDetector.getSampleCount();
+    result.elapsedMs = millis() - calStartTime;
+    result.confidence = settleDetector.getConfidence();
+    
+    logger.info("Scale", "Settle time (ms)", result.elapsedMs);
+    logger.info("Scale", "Confidence (%)", (int)result.confidence);
+    
+    if (!result.stable) {
+        logger.warning("Scale", "Load did not settle before timeout");
+        if (result.confidence < MIN_ACCEPT_CONFIDENCE) {
+            logger.error("Scale", "Reading unstable, not applied");
+            calState = SCALE_CAL_FAILED;
+            return;
+        }
+    }
     
-    // Take average of multiple readings
-    long sum = 0;
-    const int samples = 10;
+    if (calChannel == SCALE_CHANNEL_TANK) {
+        calState = applyTankCalibration(result) ? SCALE_CAL_DONE : SCALE_CAL_FAILED;
+        return;
+    }
     
-    for (int i = 0; i < samples; i++) {
-        while (!scale.available()) {
-            delay(1);
+    if (calTarget <= 0) {
+        // Zero calibration - learn zero drift per degree from zeros taken at different temperatures
+        if (hasTemperature && !isnan(zeroTemperature) &&
+            fabs(temperatureC - zeroTemperature) >= MIN_TC_LEARN_DELTA) {
+            zeroTempCoeff = (result.mean - calibratedZero) / (temperatureC - zeroTemperature);
+            logger.info("Scale", "Zero drift (counts/C)", (int)zeroTempCoeff);
+        }
+        zeroOffset = result.mean;
+        calibratedZero = zeroOffset;
+        if (hasTemperature) {
+            zeroTemperature = temperatureC;
+        }
+        logger.info("Scale", "Zero calibration complete");
+    } else {
+        int32_t rawDifference = result.mean - (int32_t)zeroOffset;
+        
+        if (rawDifference == 0) {
+            logger.error("Scale", "No weight detected!");
+            calState = SCALE_CAL_FAILED;
+            return;
         }
-        sum += scale.getReading();
-        delay(50);
+        
+        if (calAddPoint) {
+            if (!calTable.addPoint(rawDifference, calTarget)) {
+                logger.error("Scale", "Calibration table full!");
+                calState = SCALE_CAL_FAILED;
+                return;
+            }
+            logger.info("Scale", "Calibration points", (int)calTable.getCount());
+        } else {
+            calTable.setLinear(rawDifference, calTarget);
+        }
+        
+        calibrationFactor = calTable.getCountsPerGram();
+        calibrated = true;
+        if (hasTemperature) {
+            spanTemperature = temperatureC;
+        }
+        logger.info("Scale", "Calibration complete");
     }
     
-    float rawAverage = sum / (float)samples;
-    float rawDifference = rawAverage - zeroOffset;
+    calState = SCALE_CAL_DONE;
+}
+
+bool ScaleController::applyTankCalibration(const ScaleCalibrationResult& result) {
+    if (calTarget <= 0) {
+        tank.zeroOffset = result.mean;
+        logger.info("Scale", "Tank zero calibration complete");
+        return true;
+    }
     
+    float rawDifference = result.mean - tank.zeroOffset;
     if (rawDifference == 0) {
-        logger.error("Scale", "No weight detected!");
+        logger.error("Scale", "No tank weight detected!");
         return false;
     }
     
-    calibrationFactor = rawDifference / knownWeight;
-    calibrated = true;
-    
-    logger.info("Scale", "Calibration complete");
-    
+    // Tank cell only needs a linear span - resolution there is kilograms, not grams
+    tank.calibrationFactor = rawDifference / calTarget;
+    tank.calibrated = true;
+    logger.info("Scale", "Tank calibration complete");
     return true;
 }
 
@@ -127,10 +342,25 @@ void ScaleController::saveCalibration() {
     
     logger.info("Scale", "Saving calibration...");
     
-    preferences.putFloat("scaleZero", zeroOffset);
+    preferences.putFloat("scaleZero", calibratedZero);
     preferences.putFloat("scaleFactor", calibrationFactor);
     preferences.putBool("scaleCal", calibrated);
     
+    uint8_t buffer[ScaleCalTable::storageSize()];
+    size_t length = calTable.serialize(buffer, sizeof(buffer));
+    preferences.putBytes("scaleTable", buffer, length);
+    
+    // Temperature compensation reference
+    preferences.putFloat("scaleZeroT", zeroTemperature);
+    preferences.putFloat("scaleSpanT", spanTemperature);
+    preferences.putFloat("scaleZeroTC", zeroTempCoeff);
+    preferences.putFloat("scaleSpanTC", spanTempCoeff);
+    
+    // Pulp tank channel
+    preferences.putFloat("tankZero", tank.zeroOffset);
+    preferences.putFloat("tankFactor", tank.calibrationFactor);
+    preferences.putBool("tankCal", tank.calibrated);
+    
     logger.info("Scale", "Calibration saved");
 }
 
@@ -149,34 +379,351 @@ void ScaleController::loadCalibration() {
         calibrationFactor = 1.0;
         calibrated = false;
     }
+    calibratedZero = zeroOffset;
+    
+    // Multi-point table; older firmware only stored the linear factor
+    uint8_t buffer[ScaleCalTable::storageSize()];
+    size_t length = preferences.getBytes("scaleTable", buffer, sizeof(buffer));
+    if (!calTable.deserialize(buffer, length)) {
+        calTable.setLinear((int32_t)(calibrationFactor * 1000), 1000);
+    }
+    if (calibrated && !calTable.isValid()) {
+        calibrated = false;
+    }
+    
+    zeroTemperature = preferences.getFloat("scaleZeroT", NAN);
+    spanTemperature = preferences.getFloat("scaleSpanT", NAN);
+    zeroTempCoeff = preferences.getFloat("scaleZeroTC", 0);
+    spanTempCoeff = preferences.getFloat("scaleSpanTC", 0);
+    if (isnan(zeroTempCoeff)) zeroTempCoeff = 0;
+    if (isnan(spanTempCoeff)) spanTempCoeff = 0;
+    
+    tank.zeroOffset = preferences.getFloat("tankZero", 0.0);
+    tank.calibrationFactor = preferences.getFloat("tankFactor", 1.0);
+    tank.calibrated = preferences.getBool("tankCal", false);
+    if (isnan(tank.zeroOffset) || isnan(tank.calibrationFactor) || tank.calibrationFactor == 0) {
+        tank.zeroOffset = 0;
+        tank.calibrationFactor = 1.0;
+        tank.calibrated = false;
+    }
 }
 
-float ScaleController::getWeight() {
-    if (!connected || !calibrated) {
+bool ScaleController::update() {
+    if (!connected) {
+        return false;
+    }
+    
+    // Wait for internal calibration started by a rate switch
+    if (rateSwitching) {
+        if (backend->isBusy()) {
+            return false;
+        }
+        rateSwitching = false;
+        discardRemaining = getRateConfig().discardSamples;
+        resyncFilter = true;
+    }
+    
+    if (!backend->available()) {
+        if (calState == SCALE_CAL_MEASURING) {
+            updateCalibration(false);   // Timeout still advances without samples
+        }
+        return false;
+    }
+    
+    long raw = backend->read();
+    
+    // Drop settling samples after a rate, channel or sensor switch. After a
+    // rate switch the filter restarts from the last good value so the weight
+    // output stays continuous; a tank burst keeps the filter state as it was
+    if (discardRemaining > 0) {
+        discardRemaining--;
+        if (discardRemaining == 0 && resyncFilter) {
+            filter.reset(lastFiltered);
+            resyncFilter = false;
+        }
+        return false;
+    }
+    
+    // This conversion came from the internal temperature sensor
+    if (tempPending) {
+        finishTemperatureRead(raw);
+        return false;
+    }
+    
+    if (activeChannel == SCALE_CHANNEL_TANK) {
+        processTankSample(raw);
+        return false;
+    }
+    
+    lastRaw = raw;
+    lastFiltered = filter.process(lastRaw);
+    
+    if (autoRate) {
+        updateAutoRate();
+    }
+    
+    // Tank calibrations are fed from processTankSample()
+    if (calState == SCALE_CAL_MEASURING && calChannel == SCALE_CHANNEL_STARCH) {
+        updateCalibration(true);
+    }
+    
+    if (zeroTrackEnabled) {
+        updateZeroTracking();
+    }
+    
+    // Periodic temperature sample, only while the load stream is not critical
+    unsigned long now = millis();
+    if (tempCompEnabled && backend->hasTemperatureSensor() && calState != SCALE_CAL_MEASURING &&
+        !dispenseActive && activeProfile != SCALE_PROFILE_FAST && !filter.isSettling() &&
+        (!hasTemperature || now - lastTempRead >= TEMP_READ_INTERVAL)) {
+        startTemperatureRead();
+    } else if (tankBurstDue(now)) {
+        selectChannel(SCALE_CHANNEL_TANK);
+    }
+    
+    // Measure delivered sample rate over 1 second windows
+    rateWindowSamples++;
+    if (now - rateWindowStart >= 1000) {
+        measuredRate = rateWindowSamples * 1000.0f / (now - rateWindowStart);
+        measuredTankRate = tankWindowSamples * 1000.0f / (now - rateWindowStart);
+        rateWindowSamples = 0;
+        tankWindowSamples = 0;
+        rateWindowStart = now;
+    }
+    
+    return true;
+}
+
+bool ScaleController::tankBurstDue(unsigned long now) {
+    if (!tankEnabled || dispenseActive || backend->getChannelCount() < 2) {
+        return false;
+    }
+    
+    // A tank calibration owns the converter until it finishes
+    if (calState == SCALE_CAL_MEASURING) {
+        return calChannel == SCALE_CHANNEL_TANK;
+    }
+    
+    return !rateSwitching && now - lastTankBurst >= tankInterval;
+}
+
+void ScaleController::selectChannel(ScaleChannel channel) {
+    if (channel == activeChannel) return;
+    
+    if (!backend->setChannel(channel)) {
+        logger.warning("Scale", "Channel switch failed", (int)channel);
+        return;
+    }
+    
+    activeChannel = channel;
+    discardRemaining = getRateConfig().discardSamples;
+    
+    if (channel == SCALE_CHANNEL_TANK) {
+        burstRemaining = TANK_BURST_SAMPLES;
+        lastTankBurst = millis();
+    } else {
+        burstRemaining = 0;
+    }
+}
+
+void ScaleController::processTankSample(long raw) {
+    tank.lastRaw = raw;
+    tank.lastFiltered = tank.filter.process(raw);
+    tank.lastSampleTime = millis();
+    tankWindowSamples++;
+    
+    if (calState == SCALE_CAL_MEASURING && calChannel == SCALE_CHANNEL_TANK) {
+        updateCalibration(true);
+        return;   // Stay on the tank input while it is being calibrated
+    }
+    
+    if (burstRemaining > 0) {
+        burstRemaining--;
+    }
+    if (burstRemaining == 0) {
+        selectChannel(SCALE_CHANNEL_STARCH);
+    }
+}
+
+void ScaleController::setTankChannel(bool enabled) {
+    if (enabled == tankEnabled) return;
+    
+    tankEnabled = enabled;
+    logger.info("Scale", "Tank channel", enabled ? "ON" : "OFF");
+    
+    if (!connected) return;
+    
+    if (enabled && backend->getChannelCount() < 2) {
+        logger.warning("Scale", "Tank channel needs a two-channel ADC", backend->getName());
+    }
+    if (!enabled) {
+        selectChannel(SCALE_CHANNEL_STARCH);
+    }
+}
+
+float ScaleController::getTankWeight() {
+    if (!connected || !tank.calibrated || !tank.filter.isPrimed() || tank.calibrationFactor == 0) {
+        return 0.0;
+    }
+    
+    float weight = (tank.lastFiltered - tank.zeroOffset) / tank.calibrationFactor;
+    return (weight < 0) ? 0.0 : weight;
+}
+
+bool ScaleController::isTankReady() {
+    if (!connected || !tankEnabled || !tank.calibrated || !tank.filter.isPrimed()) {
+        return false;
+    }
+    return millis() - tank.lastSampleTime < TANK_STALE_TIME;
+}
+
+float ScaleController::countsToGrams(float counts) {
+    if (calibrationFactor == 0) {
         return 0.0;
     }
+    return counts / calibrationFactor;
+}
+
+float ScaleController::compensatedCounts(long filtered) {
+    float counts = filtered - zeroOffset;
+    
+    if (tempCompEnabled && hasTemperature && !isnan(zeroTemperature)) {
+        counts -= zeroTempCoeff * (temperatureC - zeroTemperature);
+    }
+    return counts;
+}
+
+float ScaleController::gramsFromFiltered(long filtered) {
+    float spanCorrection = 1.0f;
+    
+    if (tempCompEnabled && hasTemperature && !isnan(spanTemperature)) {
+        spanCorrection -= spanTempCoeff * 1e-6f * (temperatureC - spanTemperature);
+    }
     
-    if (!scale.available()) {
-        return 0.0; // No new data
+    return calTable.evaluate((int32_t)compensatedCounts(filtered)) * spanCorrection;
+}
+
+float ScaleController::getWeight() {
+    if (!connected || !calibrated || !filter.isPrimed()) {
+        return 0.0;
     }
     
-    long rawValue = scale.getReading();
-    float weight = (rawValue - zeroOffset) / calibrationFactor;
+    float weight = gramsFromFiltered(lastFiltered);
     
     // Return 0 for negative weights
     return (weight < 0) ? 0.0 : weight;
 }
 
+float ScaleController::getNetWeight() {
+    if (!connected || !calibrated || !filter.isPrimed()) {
+        return 0.0;
+    }
+    
+    // Signed - a loss-in-weight dispense reads negative
+    return gramsFromFiltered(lastFiltered) - tareGrams;
+}
+
+bool ScaleController::tare() {
+    // Uses the cached filtered value - no extra sampling delay
+    tareGrams = (calibrated && filter.isPrimed()) ? gramsFromFiltered(lastFiltered) : 0;
+    bool stable = !filter.isSettling();
+    
+    if (!stable) {
+        logger.warning("Scale", "Tare taken while load moving");
+    }
+    return stable;
+}
+
+void ScaleController::beginDispense() {
+    dispenseActive = true;
+    if (connected) {
+        selectChannel(SCALE_CHANNEL_STARCH);   // Cut any tank burst short
+    }
+    
+    // Keep a rate that already keeps up with the dose rather than paying for
+    // the switch discards. Otherwise switch before the tare: the tare reads
+    // the cached value, and the fast switch skips the AFE recal, so the only
+    // gap is a few conversions at 320 SPS.
+    if (activeRate >= DISPENSE_MIN_RATE) {
+        autoRate = false;
+    } else {
+        setRateProfile(SCALE_PROFILE_FAST);
+    }
+    tare();
+}
+
+void ScaleController::endDispense() {
+    dispenseActive = false;
+    setAutoRate(true);
+}
+
+void ScaleController::setZeroTracking(bool enabled, float bandGrams, float limitGrams) {
+    if (enabled != zeroTrackEnabled) {
+        zeroTrackSince = 0;
+        logger.info("Scale", "Zero tracking", enabled ? "ON" : "OFF");
+    }
+    zeroTrackEnabled = enabled;
+    zeroTrackBand = bandGrams;
+    zeroTrackLimit = limitGrams;
+}
+
+float ScaleController::getZeroDrift() {
+    return countsToGrams(zeroOffset - calibratedZero);
+}
+
+void ScaleController::updateZeroTracking() {
+    unsigned long now = millis();
+    
+    if (dispenseActive || calState == SCALE_CAL_MEASURING || !calibrated ||
+        filter.isSettling() || calibrationFactor == 0) {
+        zeroTrackSince = 0;
+        return;
+    }
+    
+    // Only creep when the reading sits quietly inside the band around zero
+    float offset = compensatedCounts(lastFiltered);
+    float bandCounts = fabs(zeroTrackBand * calibrationFactor);
+    if (fabs(offset) > bandCounts || filter.getNoise() > bandCounts / 2) {
+        zeroTrackSince = 0;
+        return;
+    }
+    
+    if (zeroTrackSince == 0) {
+        zeroTrackSince = now;
+        lastZeroTrack = now;
+        return;
+    }
+    if (now - zeroTrackSince < ZERO_TRACK_HOLD || now - lastZeroTrack < ZERO_TRACK_INTERVAL) {
+        return;
+    }
+    lastZeroTrack = now;
+    
+    // Move 1/8 of the remaining offset per interval, bounded around the calibrated zero
+    float limitCounts = fabs(zeroTrackLimit * calibrationFactor);
+    float newZero = zeroOffset + offset / 8.0f;
+    if (newZero > calibratedZero + limitCounts) newZero = calibratedZero + limitCounts;
+    if (newZero < calibratedZero - limitCounts) newZero = calibratedZero - limitCounts;
+    
+    if (newZero != zeroOffset) {
+        zeroOffset = newZero;
+        logger.verbose("Scale", "Zero tracked, drift (mg)", (int)(getZeroDrift() * 1000));
+    }
+}
+
 long ScaleController::getRawReading() {
     if (!connected) {
         return 0;
     }
     
-    if (!scale.available()) {
+    return lastRaw;
+}
+
+long ScaleController::getFilteredReading() {
+    if (!connected) {
         return 0;
     }
     
-    return scale.getReading();
+    return lastFiltered;
 }
 
 bool ScaleController::isReady() {
@@ -184,5 +731,147 @@ bool ScaleController::isReady() {
         return false;
     }
     
-    return scale.available();
+    return filter.isPrimed();
+}
+
+void ScaleController::configureFilter(const SignalFilterConfig& config) {
+    filter.configure(config);
+    logger.info("Scale", "Filter reconfigured, median", config.medianSize);
+}
+
+float ScaleController::getNoiseGrams() {
+    return fabs(countsToGrams(filter.getNoise()));
+}
+
+float ScaleController::getInputNoiseGrams() {
+    return fabs(countsToGrams(filter.getInputNoise()));
+}
+
+unsigned long ScaleController::getSettlingTimeMs() {
+    return (unsigned long)filter.getLastSettlingSamples() * 1000UL / activeRate;
+}
+
+void ScaleController::setRateProfile(ScaleRateProfile profile) {
+    autoRate = false;
+    applyRateProfile(profile);
+}
+
+void ScaleController::setAutoRate(bool enabled) {
+    autoRate = enabled;
+    lastMotionTime = millis();
+    logger.info("Scale", "Auto rate", enabled ? "ON" : "OFF");
+    
+    // Auto mode idles at the rest rate; a running fast profile drops there on its own
+    if (enabled && activeProfile != SCALE_PROFILE_FAST) {
+        applyRateProfile(SCALE_PROFILE_REST);
+    }
+}
+
+void ScaleController::applyRateProfile(ScaleRateProfile profile) {
+    if (profile >= SCALE_PROFILE_COUNT || profile == activeProfile) return;
+    
+    activeProfile = profile;
+    const ScaleRateProfileConfig& cfg = rateProfiles[profile];
+    
+    if (!connected) {
+        logger.info("Scale", "Rate profile", cfg.name);
+        filter.configure(cfg.filter);
+        return;
+    }
+    
+    // Nothing to do if the backend would stay on the rate it already runs
+    // (HX711 is fixed, NAU7802 rounds to its own steps)
+    if (backend->getSupportedRate(cfg.sps) == activeRate) return;
+    
+    logger.info("Scale", "Rate profile", cfg.name);
+    
+    // AFE calibration must run on the starch input
+    selectChannel(SCALE_CHANNEL_STARCH);
+    
+    // Backend may recalibrate internally; update() waits for it without
+    // blocking and then discards the first conversions. Fast is entered on
+    // motion, where a recal would blank the very readings we sped up for -
+    // it only runs when dropping back to a low noise rate.
+    activeRate = backend->setRate(cfg.sps, profile != SCALE_PROFILE_FAST);
+    rateSwitching = true;
+    discardRemaining = 0;
+    
+    long holdValue = lastFiltered;
+    filter.configure(getRateConfig().filter);
+    filter.reset(holdValue);
+    
+    rateWindowStart = millis();
+    rateWindowSamples = 0;
+}
+
+void ScaleController::updateAutoRate() {
+    unsigned long now = millis();
+    
+    if (filter.isSettling()) {
+        // Load is moving - react at full rate
+        lastMotionTime = now;
+        if (activeProfile != SCALE_PROFILE_FAST) {
+            applyRateProfile(SCALE_PROFILE_FAST);
+        }
+    } else if (activeProfile == SCALE_PROFILE_FAST && now - lastMotionTime >= AUTO_REST_DELAY) {
+        // Stable long enough - drop to the low noise rate
+        applyRateProfile(SCALE_PROFILE_REST);
+    }
+}
+
+void ScaleController::setTemperatureCompensation(bool enabled) {
+    if (enabled == tempCompEnabled) return;
+    
+    tempCompEnabled = enabled;
+    logger.info("Scale", "Temperature compensation", enabled ? "ON" : "OFF");
+}
+
+void ScaleController::setSpanTempCoefficient(float ppmPerDegree) {
+    spanTempCoeff = ppmPerDegree;
+}
+
+void ScaleController::startTemperatureRead() {
+    backend->beginTemperatureRead();
+    tempPending = true;
+    discardRemaining = TEMP_DISCARD_SAMPLES;
+}
+
+void ScaleController::finishTemperatureRead(long raw) {
+    float temperature = backend->endTemperatureRead(raw);
+    tempPending = false;
+    
+    // Restoring the load gain may start a recalibration - wait for it like
+    // a rate switch, then drop the settle conversions
+    rateSwitching = true;
+    discardRemaining = 0;
+    lastTempRead = millis();
+    
+    if (!isnan(temperature)) {
+        temperatureC = temperature;
+        hasTemperature = true;
+    }
+    
+    logger.verbose("Scale", "Temperature (C)", (int)temperatureC);
+}
+
+void ScaleController::logStatistics() {
+    if (!connected) return;
+    
+    logger.debug("Scale", "Backend", backend->getName());
+    logger.debug("Scale", "Rate profile", rateProfiles[activeProfile].name);
+    logger.debug("Scale", "Sample rate (sps)", (int)measuredRate);
+    logger.debug("Scale", "Raw noise (counts)", (int)filter.getInputNoise());
+    logger.debug("Scale", "Filtered noise (counts)", (int)filter.getNoise());
+    logger.debug("Scale", "Last settling (ms)", getSettlingTimeMs());
+    logger.debug("Scale", "Steps detected", (int)filter.getStepCount());
+    if (hasTemperature) {
+        logger.debug("Scale", "Temperature (C)", (int)temperatureC);
+    }
+    if (zeroTrackEnabled) {
+        logger.debug("Scale", "Zero drift (mg)", (int)(getZeroDrift() * 1000));
+    }
+    if (tankEnabled) {
+        logger.debug("Scale", "Tank weight (g)", (int)getTankWeight());
+        logger.debug("Scale", "Tank rate (sps)", (int)measuredTankRate);
+    }
 }
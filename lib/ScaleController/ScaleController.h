@@ -1,50 +1,264 @@
 /*
  * Scale Controller
- * Manages NAU7802 24-bit ADC for load cell weight measurements
+ * Load cell weight measurements through a pluggable ADC backend (NAU7802 / HX711)
  */
 
 #ifndef SCALECONTROLLER_H
 #define SCALECONTROLLER_H
 
 #include <Arduino.h>
-#include <SparkFun_Qwiic_Scale_NAU7802_Arduino_Library.h>
+#include <SignalFilter.h>
+#include "ScaleCalTable.h"
+#include "ScaleBackend.h"
+#include "NAU7802Backend.h"
+#include "HX711Backend.h"
+
+// Sample rate profiles (rate vs. noise trade-off)
+enum ScaleRateProfile {
+    SCALE_PROFILE_PRECISION,  // 10 SPS  - lowest noise, calibration
+    SCALE_PROFILE_REST,       // 40 SPS  - idle monitoring
+    SCALE_PROFILE_NORMAL,     // 80 SPS  - general use
+    SCALE_PROFILE_FAST,       // 320 SPS - dispensing, fastest reaction
+    SCALE_PROFILE_COUNT
+};
+
+// Per-profile ADC and filter settings
+struct ScaleRateProfileConfig {
+    const char* name;
+    uint16_t sps;                 // Requested samples per second (backend picks nearest)
+    uint8_t discardSamples;       // Samples to drop after a rate switch
+    SignalFilterConfig filter;    // Filter tuned for this rate
+};
+
+// Outcome of a settled measurement used for calibration
+struct ScaleCalibrationResult {
+    bool stable;                  // Stability criterion met before timeout
+    long mean;                    // Settled raw reading (counts)
+    uint32_t noise;               // Window standard deviation (counts)
+    uint16_t samples;             // Samples taken
+    unsigned long elapsedMs;      // Time until settled (or timeout)
+    uint8_t confidence;           // 0-100, >= 50 when stable
+};
+
+// Load cell inputs (NAU7802 channel 1 / channel 2)
+enum ScaleChannel {
+    SCALE_CHANNEL_STARCH,         // Dispensing scale - primary stream
+    SCALE_CHANNEL_TANK,           // Pulp tank load cell - sampled in short bursts
+    SCALE_CHANNEL_COUNT
+};
+
+// Calibration and filtered stream of the secondary (tank) channel
+struct ScaleChannelState {
+    SignalFilter filter;
+    float zeroOffset;
+    float calibrationFactor;      // counts per gram (linear)
+    bool calibrated;
+    long lastRaw;
+    long lastFiltered;
+    unsigned long lastSampleTime;
+};
+
+// Non-blocking calibration state (advanced by update())
+enum ScaleCalState {
+    SCALE_CAL_IDLE,
+    SCALE_CAL_MEASURING,          // Waiting for the load to settle
+    SCALE_CAL_DONE,               // Result applied
+    SCALE_CAL_FAILED              // Unstable or invalid, nothing applied
+};
 
 class ScaleController {
 public:
     ScaleController();
     
-    // Initialization
-    bool init();
+    // Initialization - NAU7802 first, HX711 on the given pins as fallback
+    bool init(uint8_t hx711DoutPin = 255, uint8_t hx711SckPin = 255, uint16_t hx711Rate = 10);
     
-    // Calibration methods
+    // Calibration methods (non-blocking - progress is driven by update())
     void startCalibration();
-    bool calibrateZero();                    // Tare/zero calibration
-    bool calibrateKnownWeight(float weight); // Calibrate with known weight
+    bool beginZeroCalibration(ScaleChannel channel = SCALE_CHANNEL_STARCH);          // Tare/zero calibration
+    bool beginWeightCalibration(float weight, ScaleChannel channel = SCALE_CHANNEL_STARCH);  // Known weight (resets table)
+    bool beginPointCalibration(float weight);       // Add a point to the multi-point table
+    void cancelCalibration();
+    ScaleCalState getCalibrationState() { return calState; }
+    uint8_t getCalibrationProgress();               // 0-100
     void saveCalibration();
     void loadCalibration();
     
+    // Settle detection used by calibration (noise in counts, 1 sigma)
+    void setSettleCriteria(uint16_t maxNoiseCounts, uint8_t holdSamples, unsigned long timeoutMs);
+    const ScaleCalibrationResult& getLastCalibrationResult() { return lastCalResult; }
+    
+    // Sampling (call update() in loop - pulls new samples through the filter)
+    bool update();                           // Returns true if a new sample was processed
+    
     // Weight reading
-    float getWeight();                       // Get weight in grams
-    long getRawReading();                    // Get raw ADC value
-    bool isReady();                          // Check if new reading available
+    float getWeight();                       // Get filtered weight in grams
+    float getNetWeight();                    // Signed weight since the last tare
+    long getRawReading();                    // Get last raw ADC value
+    long getFilteredReading();               // Get last filtered ADC value
+    bool isReady();                          // Filter primed - enough samples for a valid reading
+    
+    // Filter configuration and statistics
+    void configureFilter(const SignalFilterConfig& config);
+    SignalFilter& getFilter() { return filter; }
+    float getNoiseGrams();                   // Filtered output noise (1 sigma)
+    float getInputNoiseGrams();              // Raw input noise (1 sigma)
+    unsigned long getSettlingTimeMs();       // Last step settling time
+    float getSampleRate() { return measuredRate; }
+    void logStatistics();
+    
+    // Sample rate profiles
+    void setRateProfile(ScaleRateProfile profile);   // Manual selection (disables auto)
+    void setAutoRate(bool enabled);                  // Fast while load moves, rest when stable
+    ScaleRateProfile getRateProfile() { return activeProfile; }
+    bool isAutoRate() { return autoRate; }
+    bool isSwitchingRate() { return rateSwitching || discardRemaining > 0; }
+    uint16_t getActiveRate() { return activeRate; }     // Rate the backend actually runs
+    static const ScaleRateProfileConfig& getProfileConfig(ScaleRateProfile profile);
+    
+    // Tare and dispense bracketing
+    bool tare();                             // Instant tare from the filtered stream (false if moving)
+    void beginDispense();                    // Pin a fast rate, tare, suspend zero tracking
+    void endDispense();                      // Back to auto rate, zero tracking allowed
+    bool isDispensing() { return dispenseActive; }
+    float getTare() { return tareGrams; }
+    
+    // Automatic zero tracking while idle (band: track only within +/- band of zero,
+    // limit: total correction allowed around the calibrated zero, both in grams)
+    void setZeroTracking(bool enabled, float bandGrams, float limitGrams);
+    bool isZeroTracking() { return zeroTrackEnabled; }
+    float getZeroDrift();                    // Grams tracked away from calibrated zero
     
     // Calibration data access
     float getZeroOffset() { return zeroOffset; }
     float getCalibrationFactor() { return calibrationFactor; }
-    void setZeroOffset(float offset) { zeroOffset = offset; }
+    void setZeroOffset(float offset) { zeroOffset = offset; calibratedZero = offset; }
     void setCalibrationFactor(float factor) { calibrationFactor = factor; }
     
+    const ScaleCalTable& getCalibrationTable() { return calTable; }
+    
+    // Pulp tank channel - interleaved with the starch stream in short bursts,
+    // suspended while dispensing so the starch channel keeps its full rate
+    void setTankChannel(bool enabled);
+    bool isTankChannelEnabled() { return tankEnabled; }
+    void setTankInterval(unsigned long intervalMs) { tankInterval = intervalMs; }
+    float getTankWeight();                   // Filtered tank weight in grams
+    long getTankFilteredReading() { return tank.lastFiltered; }
+    bool isTankReady();                      // Calibrated and recently sampled
+    bool isTankCalibrated() { return tank.calibrated; }
+    float getTankSampleRate() { return measuredTankRate; }
+    
+    // Temperature compensation (NAU7802 internal sensor)
+    void setTemperatureCompensation(bool enabled);
+    bool isTemperatureCompensated() { return tempCompEnabled; }
+    float getTemperature() { return temperatureC; }
+    bool hasTemperatureReading() { return hasTemperature; }
+    float getZeroTempCoefficient() { return zeroTempCoeff; }   // counts per degree C
+    void setSpanTempCoefficient(float ppmPerDegree);
+    
     // Status
     bool isCalibrated() { return calibrated; }
     bool isConnected() { return connected; }
+    const char* getBackendName() { return backend ? backend->getName() : "None"; }
 
 private:
-    NAU7802 scale;
+    NAU7802Backend nauBackend;
+    HX711Backend hxBackend;
+    ScaleBackend* backend;                   // Detected backend (nullptr if none)
+    
+    SignalFilter filter;
+    ScaleCalTable calTable;
     
     float zeroOffset;
     float calibrationFactor;
     bool calibrated;
     bool connected;
+    
+    // Sample stream
+    long lastRaw;
+    long lastFiltered;
+    unsigned long rateWindowStart;
+    uint16_t rateWindowSamples;
+    float measuredRate;                      // Samples per second actually delivered
+    
+    // Rate profile switching
+    ScaleRateProfile activeProfile;
+    bool autoRate;
+    uint16_t activeRate;
+    bool rateSwitching;                      // Backend recalibrating after a rate/gain switch
+    uint8_t discardRemaining;                // Settling samples still to drop
+    unsigned long lastMotionTime;
+    static const unsigned long AUTO_REST_DELAY = 3000;  // Stable time before dropping to rest rate
+    static const uint16_t DISPENSE_MIN_RATE = 80;       // Slowest rate a dose runs at without switching
+    
+    // Channel interleaving
+    ScaleChannelState tank;
+    bool tankEnabled;
+    ScaleChannel activeChannel;              // Input the backend is converting
+    uint8_t burstRemaining;                  // Tank samples left in the current burst
+    unsigned long tankInterval;              // ms between tank bursts
+    unsigned long lastTankBurst;
+    uint16_t tankWindowSamples;
+    float measuredTankRate;
+    bool resyncFilter;                       // Restart the filter once discards are done
+    static const uint8_t TANK_BURST_SAMPLES = 4;
+    static const unsigned long DEFAULT_TANK_INTERVAL = 1000;
+    static const unsigned long TANK_STALE_TIME = 5000;      // Reading too old to trust
+    
+    // Calibration settle detection
+    SettleDetector settleDetector;
+    unsigned long settleTimeoutMs;
+    ScaleCalibrationResult lastCalResult;
+    ScaleCalState calState;
+    ScaleChannel calChannel;
+    float calTarget;                                          // 0 = zero calibration
+    bool calAddPoint;                                         // Add to table instead of replacing
+    unsigned long calStartTime;
+    static const uint16_t DEFAULT_SETTLE_NOISE = 40;          // counts, 1 sigma
+    static const uint8_t DEFAULT_SETTLE_HOLD = 8;             // quiet samples
+    static const unsigned long DEFAULT_SETTLE_TIMEOUT = 8000; // ms
+    static const uint8_t MIN_ACCEPT_CONFIDENCE = 25;          // accept slightly noisy result on timeout
+    
+    // Temperature compensation
+    bool tempCompEnabled;
+    bool tempPending;                                         // Next conversion is the temperature
+    bool hasTemperature;
+    float temperatureC;
+    unsigned long lastTempRead;
+    float zeroTemperature;                                    // Temperature at last zero (NAN = unknown)
+    float spanTemperature;                                    // Temperature at span calibration
+    float zeroTempCoeff;                                      // counts per degree C
+    float spanTempCoeff;                                      // ppm per degree C
+    static const unsigned long TEMP_READ_INTERVAL = 30000;
+    static const uint8_t TEMP_DISCARD_SAMPLES = 3;
+    static constexpr float MIN_TC_LEARN_DELTA = 5.0f;         // degrees between zeros to learn drift
+    
+    // Tare and zero tracking
+    float tareGrams;
+    bool dispenseActive;
+    float calibratedZero;                                     // Zero from the last zero calibration
+    bool zeroTrackEnabled;
+    float zeroTrackBand;                                      // grams
+    float zeroTrackLimit;                                     // grams
+    unsigned long zeroTrackSince;                             // 0 = not inside the band
+    unsigned long lastZeroTrack;
+    static const unsigned long ZERO_TRACK_HOLD = 5000;        // quiet time before tracking starts
+    static const unsigned long ZERO_TRACK_INTERVAL = 1000;    // one correction step per interval
+    
+    void updateZeroTracking();
+    float compensatedCounts(long filtered);
+    float gramsFromFiltered(long filtered);
+    void startTemperatureRead();
+    void finishTemperatureRead(long raw);
+    void updateCalibration(bool newSample);
+    bool applyTankCalibration(const ScaleCalibrationResult& result);
+    void selectChannel(ScaleChannel channel);
+    bool tankBurstDue(unsigned long now);
+    void processTankSample(long raw);
+    void applyRateProfile(ScaleRateProfile profile);
+    void updateAutoRate();
+    const ScaleRateProfileConfig& getRateConfig();     // Profile tuned for the rate actually running
+    float countsToGrams(float counts);
 };
 
 #endif // SCALECONTROLLER_H
@@ -0,0 +1,19 @@
+/*
+ * Resource Arbiter Implementation
+ */
+
+#include "ResourceArbiter.h"
+
+ResourceArbiter::ResourceArbiter() {
+    busyMask = 0;
+}
+
+bool ResourceArbiter::acquire(uint16_t mask) {
+    if (busyMask & mask) return false;
+    busyMask |= mask;
+    return true;
+}
+
+void ResourceArbiter::release(uint16_t mask) {
+    busyMask &= ~mask;
+}
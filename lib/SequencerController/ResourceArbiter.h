@@ -0,0 +1,30 @@
+/*
+ * Resource Arbiter
+ * Ownership of machine resource groups shared between sequencer lanes
+ *
+ * A resource is a bit in a 16-bit mask (a relay group such as the mixer
+ * or the mould vacuum). A step acquires all of its resources at once or
+ * none of them, so two lanes never drive the same group.
+ */
+
+#ifndef RESOURCEARBITER_H
+#define RESOURCEARBITER_H
+
+#include <Arduino.h>
+
+class ResourceArbiter {
+public:
+    ResourceArbiter();
+
+    bool acquire(uint16_t mask);              // All or nothing
+    void release(uint16_t mask);
+    void releaseAll() { busyMask = 0; }
+
+    bool isFree(uint16_t mask) { return (busyMask & mask) == 0; }
+    uint16_t getBusyMask() { return busyMask; }
+
+private:
+    uint16_t busyMask;
+};
+
+#endif // RESOURCEARBITER_H
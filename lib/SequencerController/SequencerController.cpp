@@ -0,0 +1,309 @@
+/*
+ * Sequencer Controller Implementation
+ */
+
+#include "SequencerController.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+SequencerController::SequencerController() {
+    steps = nullptr;
+    stepCount = 0;
+    safeState = nullptr;
+    arbiter = nullptr;
+    stepCallback = nullptr;
+    name = "Seq";
+    state = SEQ_STATE_IDLE;
+    stepIndex = 0;
+    stepStart = 0;
+    enteredAt = 0;
+    pausedElapsed = 0;
+    continuous = true;
+    waitingResources = false;
+    pendingResume = false;
+    hasNextStep = false;
+    nextStep = 0;
+    waitStart = 0;
+    faultReason = "";
+    batchCount = 0;
+    batchStart = 0;
+    lastBatchTime = 0;
+    resetStatistics();
+}
+
+void SequencerController::init(const SequencerStep* stepTable, uint8_t count, void (*safeStateCallback)(),
+                               ResourceArbiter* resourceArbiter) {
+    steps = stepTable;
+    stepCount = (count > MAX_STEPS) ? MAX_STEPS : count;
+    safeState = safeStateCallback;
+    arbiter = resourceArbiter;
+    state = SEQ_STATE_IDLE;
+}
+
+bool SequencerController::start() {
+    if (steps == nullptr || stepCount == 0) {
+        logger.error(name, "No steps configured!");
+        return false;
+    }
+    if (state != SEQ_STATE_IDLE) {
+        logger.warning(name, "Sequence already active");
+        return false;
+    }
+
+    faultReason = "";
+    batchCount = 0;
+    batchStart = millis();
+    resetStatistics();
+    state = SEQ_STATE_RUNNING;
+    logger.info(name, "Sequence started");
+    selectStep(0, false);
+    return true;
+}
+
+void SequencerController::stop() {
+    if (state == SEQ_STATE_RUNNING) {
+        leaveStep(false);
+    }
+    if (safeState) {
+        safeState();
+    }
+    state = SEQ_STATE_IDLE;
+    logger.info(name, "Sequence stopped at", getStepName());
+}
+
+void SequencerController::pause() {
+    if (state != SEQ_STATE_RUNNING) return;
+
+    pausedElapsed = getStepElapsed();
+    // A step still waiting for resources was never entered - it keeps its own resume flag
+    if (!waitingResources) {
+        pendingResume = true;
+    }
+    leaveStep(false);
+    if (safeState) {
+        safeState();
+    }
+    state = SEQ_STATE_PAUSED;
+    logger.info(name, "Paused in", getStepName());
+}
+
+bool SequencerController::resume() {
+    if (state != SEQ_STATE_PAUSED && state != SEQ_STATE_FAULTED) return false;
+
+    if (state == SEQ_STATE_FAULTED) {
+        // Retry the faulted step with a fresh timeout
+        pausedElapsed = 0;
+        faultReason = "";
+        pendingResume = true;
+    }
+
+    state = SEQ_STATE_RUNNING;
+    logger.info(name, "Resuming", getStepName());
+    selectStep(stepIndex, pendingResume);
+    return true;
+}
+
+void SequencerController::setFaultReason(const char* reason) {
+    faultReason = reason;
+}
+
+void SequencerController::setNextStep(uint8_t index) {
+    hasNextStep = true;
+    nextStep = index;
+}
+
+void SequencerController::update() {
+    if (state != SEQ_STATE_RUNNING) return;
+
+    // Step selected but another lane still owns one of its resources
+    if (waitingResources) {
+        tryEnterStep();
+        return;
+    }
+
+    const SequencerStep& step = steps[stepIndex];
+    unsigned long elapsed = getStepElapsed();
+
+    hasNextStep = false;
+    StepResult result = step.update ? step.update(elapsed) : STEP_DONE;
+
+    if (result == STEP_FAULT) {
+        fault(faultReason[0] ? faultReason : "Step fault");
+        return;
+    }
+
+    if (result == STEP_RUNNING) {
+        unsigned long timeout = getStepTimeout();
+        if (timeout > 0 && elapsed >= timeout) {
+            fault("Timeout");
+        }
+        return;
+    }
+
+    // Step done - advance
+    leaveStep(true);
+    uint8_t next = hasNextStep ? nextStep : stepIndex + 1;
+
+    if (next >= stepCount) {
+        batchCount++;
+        busyAtLastBatch = busyMs;
+        lastBatchTime = millis() - batchStart;
+        logger.info(name, "Batch complete", (int)batchCount);
+        logger.info(name, "Batch time (s)", (int)(lastBatchTime / 1000));
+
+        if (!continuous) {
+            if (safeState) {
+                safeState();
+            }
+            state = SEQ_STATE_IDLE;
+            return;
+        }
+        batchStart = millis();
+        next = 0;
+    }
+
+    selectStep(next, false);
+}
+
+void SequencerController::selectStep(uint8_t index, bool resumed) {
+    stepIndex = index;
+    if (!resumed) {
+        pausedElapsed = 0;
+    }
+    pendingResume = resumed;
+    waitingResources = true;
+    waitStart = millis();
+
+    if (!tryEnterStep()) {
+        resourceWaitCount++;
+        logger.debug(name, "Waiting for resources", steps[stepIndex].name);
+    }
+}
+
+bool SequencerController::tryEnterStep() {
+    const SequencerStep& step = steps[stepIndex];
+
+    if (arbiter && step.resources != 0 && !arbiter->acquire(step.resources)) {
+        return false;
+    }
+
+    unsigned long now = millis();
+    resourceWaitMs += now - waitStart;
+    waitingResources = false;
+    enteredAt = now;
+    stepStart = now - pausedElapsed;
+
+    logger.info(name, pendingResume ? "Resume step" : "Step", step.name);
+    if (step.enter) {
+        step.enter(pendingResume);
+    }
+    return true;
+}
+
+void SequencerController::leaveStep(bool completed) {
+    unsigned long now = millis();
+
+    if (waitingResources) {
+        // Never entered - nothing to undo
+        resourceWaitMs += now - waitStart;
+        waitingResources = false;
+        return;
+    }
+
+    const SequencerStep& step = steps[stepIndex];
+    if (completed && stepCallback) {
+        stepCallback(stepIndex, now - stepStart);
+    }
+    if (step.exit) {
+        step.exit();
+    }
+    if (arbiter && step.resources != 0) {
+        arbiter->release(step.resources);
+    }
+
+    unsigned long span = now - enteredAt;
+    if (step.resources != 0) {
+        busyMs += span;
+    } else {
+        idleMs += span;
+    }
+    stepTotalMs[stepIndex] += span;
+    if (completed) {
+        stepRuns[stepIndex]++;
+    }
+}
+
+void SequencerController::fault(const char* reason) {
+    faultReason = reason;
+    pausedElapsed = getStepElapsed();
+    leaveStep(false);
+    if (safeState) {
+        safeState();
+    }
+    state = SEQ_STATE_FAULTED;
+    logger.error(name, getStepName(), faultReason);
+}
+
+bool SequencerController::isBusy() {
+    if (state != SEQ_STATE_RUNNING || waitingResources) return false;
+    return steps[stepIndex].resources != 0;
+}
+
+const char* SequencerController::getStepName() {
+    if (steps == nullptr || stepIndex >= stepCount) return "";
+    return steps[stepIndex].name;
+}
+
+unsigned long SequencerController::getStepElapsed() {
+    if (state == SEQ_STATE_RUNNING && !waitingResources) {
+        return millis() - stepStart;
+    }
+    return pausedElapsed;
+}
+
+unsigned long SequencerController::getStepTimeout() {
+    if (steps == nullptr || stepIndex >= stepCount) return 0;
+    const SequencerStep& step = steps[stepIndex];
+    return step.timeoutMs ? step.timeoutMs() : 0;
+}
+
+uint8_t SequencerController::getUtilization() {
+    unsigned long total = busyMs + idleMs + resourceWaitMs;
+    if (total == 0) return 0;
+    return (uint8_t)((uint64_t)busyMs * 100 / total);
+}
+
+unsigned long SequencerController::getBusyTimePerBatch() {
+    if (batchCount == 0) return 0;
+    return busyAtLastBatch / batchCount;
+}
+
+unsigned long SequencerController::getStepAverage(uint8_t index) {
+    if (index >= stepCount || stepRuns[index] == 0) return 0;
+    return stepTotalMs[index] / stepRuns[index];
+}
+
+void SequencerController::resetStatistics() {
+    busyMs = 0;
+    idleMs = 0;
+    resourceWaitMs = 0;
+    resourceWaitCount = 0;
+    busyAtLastBatch = 0;
+    memset(stepTotalMs, 0, sizeof(stepTotalMs));
+    memset(stepRuns, 0, sizeof(stepRuns));
+}
+
+void SequencerController::logStatistics() {
+    logger.debug(name, "Utilization (%)", (int)getUtilization());
+    logger.debug(name, "Busy per batch (s)", (int)(getBusyTimePerBatch() / 1000));
+    if (resourceWaitCount > 0) {
+        logger.debug(name, "Resource waits", (int)resourceWaitCount);
+        logger.debug(name, "Resource wait (s)", (int)(resourceWaitMs / 1000));
+    }
+    for (uint8_t i = 0; i < stepCount; i++) {
+        if (stepRuns[i] > 0) {
+            logger.verbose(name, steps[i].name, (int)getStepAverage(i));
+        }
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Sequencer Controller
+ * Non-blocking production sequencer - a table of resumable steps
+ *
+ * Each step has entry/exit actions, a non-blocking update and an optional
+ * timeout. Steps report running/done/fault; faults stop the machine in a
+ * safe state and can be retried from the faulted step. Call update() in loop.
+ *
+ * Several sequencers can run side by side as pipeline lanes. A step names
+ * the resource groups it drives; with a shared ResourceArbiter it is only
+ * entered once every group is free, and releases them when it exits.
+ */
+
+#ifndef SEQUENCERCONTROLLER_H
+#define SEQUENCERCONTROLLER_H
+
+#include <Arduino.h>
+#include "ResourceArbiter.h"
+
+enum StepResult {
+    STEP_RUNNING,
+    STEP_DONE,
+    STEP_FAULT
+};
+
+enum SequencerState {
+    SEQ_STATE_IDLE,
+    SEQ_STATE_RUNNING,
+    SEQ_STATE_PAUSED,
+    SEQ_STATE_FAULTED
+};
+
+// One production phase. enter() receives true when the step is resumed
+// after a pause or fault (outputs were switched off in between).
+// A step that owns no resources is a wait (hand-off) step and counts as idle.
+struct SequencerStep {
+    const char* name;
+    uint16_t resources;                       // Resource groups driven by this step
+    void (*enter)(bool resumed);
+    StepResult (*update)(unsigned long elapsedMs);
+    void (*exit)();
+    unsigned long (*timeoutMs)();             // nullptr or 0 = no timeout
+};
+
+class SequencerController {
+public:
+    static const uint8_t MAX_STEPS = 16;
+
+    SequencerController();
+
+    // Initialization - safeState switches every output off (may be nullptr
+    // for a lane whose owner handles the safe state)
+    void init(const SequencerStep* steps, uint8_t stepCount, void (*safeState)(),
+              ResourceArbiter* arbiter = nullptr);
+    void setName(const char* laneName) { name = laneName; }
+    void setContinuous(bool enabled) { continuous = enabled; }
+
+    // Control
+    bool start();                             // New run from the first step
+    void stop();
+    void pause();
+    bool resume();                            // Continue a paused or faulted step
+    void update();
+
+    // Called by a step to report why it returned STEP_FAULT
+    void setFaultReason(const char* reason);
+
+    // Called by a step before returning STEP_DONE to jump instead of
+    // advancing; an index past the last step ends the batch
+    void setNextStep(uint8_t index);
+
+    // Called with each completed step and its run time (pauses excluded)
+    void setStepCallback(void (*callback)(uint8_t index, unsigned long durationMs)) { stepCallback = callback; }
+
+    // Status
+    SequencerState getState() { return state; }
+    bool isActive() { return state != SEQ_STATE_IDLE; }
+    bool isWaitingForResources() { return waitingResources; }
+    bool isBusy();                            // In a step that owns resources
+    uint8_t getStepIndex() { return stepIndex; }
+    uint8_t getStepCount() { return stepCount; }
+    const char* getName() { return name; }
+    const char* getStepName();
+    unsigned long getStepElapsed();
+    unsigned long getStepTimeout();
+    const char* getFaultReason() { return faultReason; }
+    uint32_t getBatchCount() { return batchCount; }
+    unsigned long getLastBatchTime() { return lastBatchTime; }
+
+    // Utilization - busy = working steps, idle = wait steps and resource waits
+    unsigned long getBusyTime() { return busyMs; }
+    unsigned long getIdleTime() { return idleMs + resourceWaitMs; }
+    unsigned long getResourceWaitTime() { return resourceWaitMs; }
+    uint32_t getResourceWaitCount() { return resourceWaitCount; }
+    uint8_t getUtilization();                 // Busy % of running time
+    unsigned long getBusyTimePerBatch();      // Average working time per batch
+    unsigned long getStepAverage(uint8_t index);
+    void resetStatistics();
+    void logStatistics();
+
+private:
+    const SequencerStep* steps;
+    uint8_t stepCount;
+    void (*safeState)();
+    ResourceArbiter* arbiter;
+    void (*stepCallback)(uint8_t index, unsigned long durationMs);
+    const char* name;
+
+    SequencerState state;
+    uint8_t stepIndex;
+    unsigned long stepStart;
+    unsigned long enteredAt;                  // When the current entry began (for statistics)
+    unsigned long pausedElapsed;              // Step time already done before a pause/fault
+    bool continuous;                          // Loop back to the first step after the last
+    bool waitingResources;                    // Step selected but its resources are busy
+    bool pendingResume;                       // Resume flag for the deferred enter()
+    bool hasNextStep;
+    uint8_t nextStep;
+    unsigned long waitStart;
+
+    const char* faultReason;
+    uint32_t batchCount;
+    unsigned long batchStart;
+    unsigned long lastBatchTime;
+
+    unsigned long busyMs;
+    unsigned long idleMs;
+    unsigned long resourceWaitMs;
+    uint32_t resourceWaitCount;
+    unsigned long busyAtLastBatch;
+    unsigned long stepTotalMs[MAX_STEPS];
+    uint32_t stepRuns[MAX_STEPS];
+
+    void selectStep(uint8_t index, bool resumed);
+    bool tryEnterStep();
+    void leaveStep(bool completed);
+    void fault(const char* reason);
+};
+
+#endif // SEQUENCERCONTROLLER_H
@@ -0,0 +1,363 @@
+/*
+ * Signal Filter Implementation
+ * Fixed-point median + IIR/Kalman chain with noise and settling statistics
+ */
+
+#include "SignalFilter.h"
+
+SignalFilter::SignalFilter() {
+    config.medianSize = 5;
+    config.stage = FILTER_STAGE_KALMAN;
+    config.iirShift = 3;
+    config.kalmanProcessNoise = 4;
+    config.kalmanMeasurementNoise = 400;
+    config.kalmanGate = 4;
+    config.settleBand = 50;
+    reset();
+}
+
+void SignalFilter::configure(const SignalFilterConfig& newConfig) {
+    config = newConfig;
+
+    // Clamp to supported ranges
+    if (config.medianSize < 1) config.medianSize = 1;
+    if (config.medianSize > MAX_MEDIAN) config.medianSize = MAX_MEDIAN;
+    if ((config.medianSize & 1) == 0) config.medianSize++;  // Odd sizes only
+    if (config.iirShift < 1) config.iirShift = 1;
+    if (config.iirShift > 12) config.iirShift = 12;
+    if (config.kalmanProcessNoise < 0) config.kalmanProcessNoise = 0;
+    if (config.kalmanMeasurementNoise < 1) config.kalmanMeasurementNoise = 1;
+    if (config.kalmanGate < 1) config.kalmanGate = 1;
+    if (config.settleBand < 1) config.settleBand = 1;
+
+    reset();
+}
+
+void SignalFilter::reset() {
+    memset(medianBuffer, 0, sizeof(medianBuffer));
+    medianIndex = 0;
+    state = 0;
+    kalmanP = 0;
+    kalmanR = config.kalmanMeasurementNoise;
+    output = 0;
+    sampleCount = 0;
+
+    memset(outWindow, 0, sizeof(outWindow));
+    memset(inWindow, 0, sizeof(inWindow));
+    windowIndex = 0;
+    windowCount = 0;
+    outSum = 0;
+    inSum = 0;
+    outSumSq = 0;
+    inSumSq = 0;
+    windowBase = 0;
+
+    settling = false;
+    settlingSamples = 0;
+    lastSettlingSamples = 0;
+    inBandCount = 0;
+    stepCount = 0;
+}
+
+void SignalFilter::reset(int32_t value) {
+    reset();
+
+    // Pre-load every stage so the output starts settled at value
+    for (uint8_t i = 0; i < MAX_MEDIAN; i++) {
+        medianBuffer[i] = value;
+    }
+    state = (int64_t)value << 16;
+    kalmanP = config.kalmanMeasurementNoise;
+    output = value;
+    sampleCount = config.medianSize;
+    windowBase = value;
+}
+
+int32_t SignalFilter::median() {
+    uint8_t n = config.medianSize;
+    if (sampleCount < n) {
+        n = (sampleCount == 0) ? 1 : sampleCount;
+    }
+
+    // Insertion sort of at most 7 samples - cheaper than a heap or nth_element
+    int32_t sorted[MAX_MEDIAN];
+    for (uint8_t i = 0; i < n; i++) {
+        uint8_t idx = (medianIndex + MAX_MEDIAN - 1 - i) % MAX_MEDIAN;
+        int32_t v = medianBuffer[idx];
+        int8_t j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+
+    return sorted[n / 2];
+}
+
+int32_t SignalFilter::process(int32_t raw) {
+    if (sampleCount == 0) {
+        windowBase = raw;
+    }
+
+    // Stage 1: median spike filter
+    medianBuffer[medianIndex] = raw;
+    medianIndex = (medianIndex + 1) % MAX_MEDIAN;
+    sampleCount++;
+    int32_t m = (config.medianSize > 1) ? median() : raw;
+
+    // Stage 2: smoothing
+    int64_t z = (int64_t)m << 16;
+    bool stepDetected = false;
+
+    if (sampleCount == 1) {
+        state = z;
+        kalmanP = config.kalmanMeasurementNoise;
+        kalmanR = config.kalmanMeasurementNoise;
+    } else {
+        switch (config.stage) {
+            case FILTER_STAGE_IIR: {
+                int64_t diff = z - state;
+                stepDetected = (abs(m - output) > config.settleBand * 4);
+                state += diff >> config.iirShift;
+                break;
+            }
+
+            case FILTER_STAGE_KALMAN: {
+                kalmanP += config.kalmanProcessNoise;
+
+                int64_t innovation = z - state;
+                int64_t e = innovation >> 16;
+                int64_t e2 = e * e;
+                int64_t gate = (int64_t)config.kalmanGate * config.kalmanGate;
+
+                if (e2 > gate * (kalmanP + kalmanR)) {
+                    // Real load change - open the filter up so it tracks the step quickly
+                    kalmanP += e2;
+                    stepDetected = true;
+                } else {
+                    // Adapt measurement noise to the observed innovation spread
+                    int64_t observed = e2 - kalmanP;
+                    if (observed < 1) observed = 1;
+                    kalmanR += (observed - kalmanR) >> 6;
+                    if (kalmanR < 1) kalmanR = 1;
+                }
+
+                int64_t gain = (kalmanP << 16) / (kalmanP + kalmanR);   // Q16
+                state += (gain * innovation) >> 16;
+                kalmanP = ((65536 - gain) * kalmanP) >> 16;
+                if (kalmanP < 1) kalmanP = 1;
+                break;
+            }
+
+            case FILTER_STAGE_NONE:
+            default:
+                stepDetected = (abs(m - output) > config.settleBand * 4);
+                state = z;
+                break;
+        }
+    }
+
+    // Round Q16 back to counts
+    output = (int32_t)((state + 0x8000) >> 16);
+
+    updateStatistics(raw, output);
+    updateSettling(m, output, stepDetected);
+
+    return output;
+}
+
+void SignalFilter::updateStatistics(int32_t in, int32_t out) {
+    int64_t dIn = (int64_t)in - windowBase;
+    int64_t dOut = (int64_t)out - windowBase;
+
+    if (windowCount >= WINDOW_SIZE) {
+        // Drop the oldest sample from the running sums
+        int64_t oldIn = (int64_t)inWindow[windowIndex] - windowBase;
+        int64_t oldOut = (int64_t)outWindow[windowIndex] - windowBase;
+        inSum -= oldIn;
+        inSumSq -= (uint64_t)(oldIn * oldIn);
+        outSum -= oldOut;
+        outSumSq -= (uint64_t)(oldOut * oldOut);
+    } else {
+        windowCount++;
+    }
+
+    inWindow[windowIndex] = in;
+    outWindow[windowIndex] = out;
+    inSum += dIn;
+    inSumSq += (uint64_t)(dIn * dIn);
+    outSum += dOut;
+    outSumSq += (uint64_t)(dOut * dOut);
+
+    windowIndex = (windowIndex + 1) % WINDOW_SIZE;
+}
+
+void SignalFilter::updateSettling(int32_t in, int32_t out, bool stepDetected) {
+    if (stepDetected) {
+        if (!settling) {
+            stepCount++;
+        }
+        settling = true;
+        settlingSamples = 0;
+        inBandCount = 0;
+    }
+
+    if (!settling) return;
+
+    if (settlingSamples < 0xFFFF) settlingSamples++;
+
+    if (abs(in - out) <= config.settleBand) {
+        inBandCount++;
+        if (inBandCount >= SETTLE_HOLD) {
+            settling = false;
+            lastSettlingSamples = settlingSamples;
+        }
+    } else {
+        inBandCount = 0;
+    }
+}
+
+uint32_t SignalFilter::windowVariance(int64_t sum, uint64_t sumSq, uint8_t count) {
+    if (count < 2) return 0;
+
+    // var = (n * sum(x^2) - sum(x)^2) / n^2
+    int64_t n = count;
+    int64_t num = (int64_t)(sumSq * n) - sum * sum;
+    if (num < 0) num = 0;
+    uint64_t var = (uint64_t)num / (uint64_t)(n * n);
+    return (var > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)var;
+}
+
+uint32_t SignalFilter::getVariance() {
+    return windowVariance(outSum, outSumSq, windowCount);
+}
+
+int32_t SignalFilter::getNoise() {
+    return isqrt(windowVariance(outSum, outSumSq, windowCount));
+}
+
+int32_t SignalFilter::getInputNoise() {
+    return isqrt(windowVariance(inSum, inSumSq, windowCount));
+}
+
+uint32_t SignalFilter::isqrt(uint64_t value) {
+    // Bitwise integer square root, 32 iterations worst case
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)result;
+}
+
+// ========== SettleDetector Implementation ==========
+
+SettleDetector::SettleDetector() {
+    maxVariance = 900;
+    holdSamples = 8;
+    reset();
+}
+
+void SettleDetector::configure(uint32_t maxVar, uint8_t hold) {
+    maxVariance = (maxVar < 1) ? 1 : maxVar;
+    holdSamples = (hold < 1) ? 1 : hold;
+    reset();
+}
+
+void SettleDetector::reset() {
+    memset(window, 0, sizeof(window));
+    windowIndex = 0;
+    windowCount = 0;
+    sum = 0;
+    sumSq = 0;
+    base = 0;
+    quietCount = 0;
+    sampleCount = 0;
+    stable = false;
+}
+
+bool SettleDetector::add(int32_t value) {
+    if (windowCount == 0) {
+        base = value;
+    }
+
+    int64_t d = (int64_t)value - base;
+    if (windowCount >= WINDOW_SIZE) {
+        int64_t old = (int64_t)window[windowIndex] - base;
+        sum -= old;
+        sumSq -= (uint64_t)(old * old);
+    } else {
+        windowCount++;
+    }
+    window[windowIndex] = value;
+    sum += d;
+    sumSq += (uint64_t)(d * d);
+    windowIndex = (windowIndex + 1) % WINDOW_SIZE;
+
+    if (sampleCount < 0xFFFF) sampleCount++;
+
+    // Only judge once the window is full, then require a run of quiet samples
+    if (windowCount >= WINDOW_SIZE && getVariance() <= maxVariance) {
+        if (quietCount < 0xFF) quietCount++;
+    } else {
+        quietCount = 0;
+    }
+
+    stable = (quietCount >= holdSamples);
+    return stable;
+}
+
+int32_t SettleDetector::getMean() {
+    if (windowCount == 0) return 0;
+    return base + (int32_t)(sum / windowCount);
+}
+
+uint32_t SettleDetector::getVariance() {
+    if (windowCount < 2) return 0xFFFFFFFFUL;
+
+    int64_t n = windowCount;
+    int64_t num = (int64_t)(sumSq * n) - sum * sum;
+    if (num < 0) num = 0;
+    uint64_t var = (uint64_t)num / (uint64_t)(n * n);
+    return (var > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)var;
+}
+
+uint8_t SettleDetector::getProgress() {
+    if (stable) return 100;
+    uint16_t done = windowCount + quietCount;
+    uint16_t total = WINDOW_SIZE + holdSamples;
+    return (uint8_t)(done * 100 / total);
+}
+
+uint8_t SettleDetector::getConfidence() {
+    if (windowCount < 2) return 0;
+
+    // Map variance/threshold ratio: 0 -> 100, 1 -> 50, large -> 0
+    uint64_t var = getVariance();
+    uint8_t score;
+    if (stable) {
+        uint64_t penalty = (var * 50) / maxVariance;
+        score = (penalty >= 50) ? 50 : (uint8_t)(100 - penalty);
+    } else if (var == 0) {
+        score = 49;
+    } else {
+        uint64_t ratio = ((uint64_t)maxVariance * 50) / var;
+        score = (ratio >= 49) ? 49 : (uint8_t)ratio;
+    }
+
+    // A variance from a few samples proves little - scale by window fill
+    return (uint8_t)((uint16_t)score * windowCount / WINDOW_SIZE);
+}
@@ -0,0 +1,147 @@
+/*
+ * Signal Filter
+ * Fixed-point filter chain for ADC sample streams (load cells, sensors)
+ *
+ * Pipeline: median-of-N spike filter -> IIR or adaptive Kalman stage
+ * All state is integer (Q16 for fractional stages), no heap allocation.
+ */
+
+#ifndef SIGNALFILTER_H
+#define SIGNALFILTER_H
+
+#include <Arduino.h>
+
+// Smoothing stage after the median filter
+enum FilterStage {
+    FILTER_STAGE_NONE,      // Median only
+    FILTER_STAGE_IIR,       // Single-pole low pass, alpha = 1 / 2^iirShift
+    FILTER_STAGE_KALMAN     // 1D adaptive Kalman (random walk model)
+};
+
+// Filter chain configuration
+struct SignalFilterConfig {
+    uint8_t medianSize;            // 1 (off), 3, 5 or 7 samples
+    FilterStage stage;             // Smoothing stage
+    uint8_t iirShift;              // IIR smoothing (1..12)
+    int32_t kalmanProcessNoise;    // Q - expected drift per sample (counts^2)
+    int32_t kalmanMeasurementNoise;// R - initial sensor noise (counts^2), adapted at runtime
+    uint8_t kalmanGate;            // Innovation gate (sigmas) before a step is assumed
+    int32_t settleBand;            // Band (counts) the output must stay in to count as settled
+};
+
+class SignalFilter {
+public:
+    static const uint8_t MAX_MEDIAN = 7;
+    static const uint8_t WINDOW_SIZE = 32;   // Samples used for noise statistics
+    static const uint8_t SETTLE_HOLD = 8;    // Consecutive in-band samples to declare settled
+
+    SignalFilter();
+
+    // Configuration
+    void configure(const SignalFilterConfig& config);
+    const SignalFilterConfig& getConfig() { return config; }
+
+    // Reset filter state (optionally pre-loading a value)
+    void reset();
+    void reset(int32_t value);
+
+    // Feed one raw sample, returns filtered value (same units as input)
+    int32_t process(int32_t raw);
+
+    // Filtered output
+    int32_t getValue() { return output; }
+    bool isPrimed() { return sampleCount >= config.medianSize; }
+    uint32_t getSampleCount() { return sampleCount; }
+
+    // Noise statistics over the last WINDOW_SIZE samples
+    uint32_t getVariance();                  // Output variance (counts^2)
+    int32_t getNoise();                      // Output standard deviation (counts)
+    int32_t getInputNoise();                 // Raw input standard deviation (counts)
+    bool isWindowFull() { return windowCount >= WINDOW_SIZE; }
+
+    // Settling statistics
+    bool isSettling() { return settling; }
+    uint16_t getLastSettlingSamples() { return lastSettlingSamples; }
+    uint32_t getStepCount() { return stepCount; }
+
+    // Integer square root helper
+    static uint32_t isqrt(uint64_t value);
+
+private:
+    SignalFilterConfig config;
+
+    // Median stage
+    int32_t medianBuffer[MAX_MEDIAN];
+    uint8_t medianIndex;
+    int32_t median();
+
+    // Smoothing stage state (Q16)
+    int64_t state;
+    int64_t kalmanP;            // Estimate variance (counts^2)
+    int64_t kalmanR;            // Adapted measurement variance (counts^2)
+    int32_t output;
+    uint32_t sampleCount;
+
+    // Statistics window
+    int32_t outWindow[WINDOW_SIZE];
+    int32_t inWindow[WINDOW_SIZE];
+    uint8_t windowIndex;
+    uint8_t windowCount;
+    int64_t outSum;
+    int64_t inSum;
+    uint64_t outSumSq;          // Sums are taken relative to windowBase
+    uint64_t inSumSq;
+    int32_t windowBase;
+
+    // Settling tracking
+    bool settling;
+    uint16_t settlingSamples;
+    uint16_t lastSettlingSamples;
+    uint8_t inBandCount;
+    uint32_t stepCount;
+
+    void updateStatistics(int32_t in, int32_t out);
+    void updateSettling(int32_t in, int32_t out, bool stepDetected);
+    static uint32_t windowVariance(int64_t sum, uint64_t sumSq, uint8_t count);
+};
+
+// Stability detector: windowed variance below a threshold for N consecutive samples
+class SettleDetector {
+public:
+    static const uint8_t WINDOW_SIZE = 16;
+
+    SettleDetector();
+
+    // maxVariance in counts^2, holdSamples consecutive quiet samples required
+    void configure(uint32_t maxVariance, uint8_t holdSamples);
+    void reset();
+
+    // Feed one (filtered) sample, returns true once stable
+    bool add(int32_t value);
+
+    bool isStable() { return stable; }
+    int32_t getMean();                       // Window mean (counts)
+    uint32_t getVariance();                  // Window variance (counts^2)
+    uint16_t getSampleCount() { return sampleCount; }
+    uint8_t getProgress();                   // 0-100 towards the stable verdict
+
+    // 0-100: >= 50 means the stability criterion was met over a full
+    // window, lower is noisier or based on fewer samples
+    uint8_t getConfidence();
+
+private:
+    int32_t window[WINDOW_SIZE];
+    uint8_t windowIndex;
+    uint8_t windowCount;
+    int64_t sum;
+    uint64_t sumSq;
+    int32_t base;
+
+    uint32_t maxVariance;
+    uint8_t holdSamples;
+    uint8_t quietCount;
+    uint16_t sampleCount;
+    bool stable;
+};
+
+#endif // SIGNALFILTER_H
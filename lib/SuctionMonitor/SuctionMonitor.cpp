@@ -0,0 +1,117 @@
+/*
+ * Suction Monitor Implementation
+ */
+
+#include "SuctionMonitor.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+SuctionMonitor::SuctionMonitor() {
+    adc = nullptr;
+    channel = 0;
+    enabled = true;
+    sensorOk = false;
+    zeroVolts = 0;
+    nominalZero = 0;
+    kPaPerVolt = 1;
+    active = false;
+    endpoint = false;
+    startTime = 0;
+    endTime = 0;
+    lastSample = 0;
+    vacuum = 0;
+    slope = 0;
+    peakVacuum = 0;
+    memset(window, 0, sizeof(window));
+    windowIndex = 0;
+    windowCount = 0;
+    holdCount = 0;
+}
+
+void SuctionMonitor::init(AdcScanController* scanner, uint8_t adcChannel, float zero, float scale) {
+    adc = scanner;
+    channel = adcChannel;
+    zeroVolts = zero;
+    nominalZero = zero;
+    kPaPerVolt = scale;
+    logger.info("Suction", "Vacuum end-point monitor initialized");
+}
+
+void SuctionMonitor::begin() {
+    active = true;
+    endpoint = false;
+    startTime = millis();
+    lastSample = 0;
+    peakVacuum = 0;
+    slope = 0;
+    windowIndex = 0;
+    windowCount = 0;
+    holdCount = 0;
+}
+
+void SuctionMonitor::end() {
+    if (!active) return;
+    active = false;
+    endTime = millis();
+}
+
+void SuctionMonitor::update() {
+    if (adc == nullptr) return;
+
+    unsigned long now = millis();
+    if (now - lastSample < SAMPLE_INTERVAL) return;
+    lastSample = now;
+
+    if (!adc->isFresh(channel, SAMPLE_INTERVAL * 2)) {
+        sensorOk = false;
+        endpoint = false;
+        return;
+    }
+    sensorOk = true;
+    float volts = adc->getVolts(channel);
+
+    if (!active) {
+        // Line back at atmosphere - follow the transducer's zero drift
+        if (now - endTime >= ZERO_SETTLE_TIME) {
+            zeroVolts += (volts - zeroVolts) * 0.05f;
+            zeroVolts = constrain(zeroVolts, nominalZero - ZERO_TRACK_LIMIT, nominalZero + ZERO_TRACK_LIMIT);
+        }
+        vacuum = (zeroVolts - volts) * kPaPerVolt;
+        return;
+    }
+
+    vacuum = (zeroVolts - volts) * kPaPerVolt;
+    if (vacuum > peakVacuum) peakVacuum = vacuum;
+
+    // Slope over the last second (oldest sample in the ring vs now)
+    uint8_t oldest = (windowCount < SLOPE_WINDOW) ? 0 : windowIndex;
+    if (windowCount > 0) {
+        slope = (vacuum - window[oldest]) * 1000.0f / (SAMPLE_INTERVAL * windowCount);
+    }
+    window[windowIndex] = vacuum;
+    windowIndex = (windowIndex + 1) % SLOPE_WINDOW;
+    if (windowCount < SLOPE_WINDOW) windowCount++;
+
+    if (endpoint) return;
+    if (windowCount < SLOPE_WINDOW || now - startTime < MIN_SUCTION_TIME) return;
+
+    if (vacuum >= CAKE_VACUUM && slope < PLATEAU_SLOPE) {
+        holdCount++;
+        if (holdCount >= HOLD_SAMPLES) {
+            endpoint = true;
+            logger.debug("Suction", "Plateau at (kPa)", (int)vacuum);
+        }
+    } else {
+        holdCount = 0;
+    }
+}
+
+void SuctionMonitor::logStatistics() {
+    if (!sensorOk) return;
+    logger.debug("Suction", "Vacuum (kPa)", (int)vacuum);
+    logger.verbose("Suction", "Zero (mV)", (int)(zeroVolts * 1000));
+    if (peakVacuum > 0) {
+        logger.verbose("Suction", "Last peak (kPa)", (int)peakVacuum);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Suction Monitor
+ * Vacuum-pressure end-point detection for mould suction
+ *
+ * While a mould is under suction the vacuum builds as the pulp cake forms
+ * on the mesh and levels off once the cake is complete. The line pressure
+ * (ADS1115 scan) is sampled every 100 ms; the end-point is a plateau: the
+ * vacuum has reached the cake-formed level and its slope over the last
+ * second stays under the threshold. The zero is re-learned whenever the
+ * pump has been off for a while. Call update() in loop.
+ */
+
+#ifndef SUCTIONMONITOR_H
+#define SUCTIONMONITOR_H
+
+#include <Arduino.h>
+#include <AdcScanController.h>
+
+class SuctionMonitor {
+public:
+    static const uint8_t SLOPE_WINDOW = 10;           // Samples (1 s)
+
+    SuctionMonitor();
+
+    // Initialization - transducer is linear: kPa = (zeroVolts - volts) * kPaPerVolt
+    void init(AdcScanController* adc, uint8_t channel, float zeroVolts, float kPaPerVolt);
+    void setEnabled(bool on) { enabled = on; }
+    void update();
+
+    // Suction cycle (called by the mould scheduler)
+    void begin();
+    void end();
+    bool isEndpoint() { return enabled && active && endpoint; }
+
+    // Status
+    bool isSensorOk() { return sensorOk; }
+    float getVacuum() { return vacuum; }              // kPa below atmosphere
+    float getSlope() { return slope; }                // kPa/s
+    float getPeakVacuum() { return peakVacuum; }      // This cycle
+    void logStatistics();
+
+private:
+    AdcScanController* adc;
+    uint8_t channel;
+    bool enabled;
+    bool sensorOk;
+    float zeroVolts;
+    float nominalZero;
+    float kPaPerVolt;
+
+    bool active;
+    bool endpoint;
+    unsigned long startTime;
+    unsigned long endTime;
+    unsigned long lastSample;
+    float vacuum;
+    float slope;
+    float peakVacuum;
+    float window[SLOPE_WINDOW];
+    uint8_t windowIndex;
+    uint8_t windowCount;
+    uint8_t holdCount;
+
+    static const unsigned long SAMPLE_INTERVAL = 100;     // ms
+    static const unsigned long MIN_SUCTION_TIME = 1500;   // ms before an end-point counts
+    static const unsigned long ZERO_SETTLE_TIME = 2000;   // ms pump off before re-zeroing
+    static const uint8_t HOLD_SAMPLES = 5;                // Plateau must hold this long
+    static constexpr float CAKE_VACUUM = 30.0f;           // kPa - cake formed on the mesh
+    static constexpr float PLATEAU_SLOPE = 1.0f;          // kPa/s
+    static constexpr float ZERO_TRACK_LIMIT = 0.2f;       // V from the nominal zero
+};
+
+#endif // SUCTIONMONITOR_H
@@ -0,0 +1,210 @@
+/*
+ * Tray Sensor Controller Implementation
+ */
+
+#include "TraySensorController.h"
+#include <LogController.h>
+
+extern LogController logger;
+
+TraySensorController* TraySensorController::instance = nullptr;
+
+TraySensorController::TraySensorController() {
+    pin = 255;
+    initialized = false;
+    debounceTime = DEFAULT_DEBOUNCE_US;
+    head = 0;
+    tail = 0;
+    overruns = 0;
+    mux = portMUX_INITIALIZER_UNLOCKED;
+    trayPresent = false;
+    hasPending = false;
+    pendingPresent = false;
+    pendingTime = 0;
+    glitchCount = 0;
+    trayCount = 0;
+    hasLeading = false;
+    hasTrailing = false;
+    lastLeading = 0;
+    lastTrailing = 0;
+    trayLengthUs = 0;
+    trayGapUs = 0;
+    trayPitchUs = 0;
+    avgPitchUs = 0;
+    eventCallback = nullptr;
+}
+
+bool TraySensorController::init(uint8_t sensorPin) {
+    pin = sensorPin;
+    pinMode(pin, INPUT_PULLUP);
+
+    // Start from the current beam state so a tray under the sensor is not counted
+    trayPresent = (digitalRead(pin) == LOW);
+    head = 0;
+    tail = 0;
+    overruns = 0;
+
+    instance = this;
+    attachInterrupt(digitalPinToInterrupt(pin), edgeISR, CHANGE);
+    initialized = true;
+
+    logger.info("Tray", "IR tray sensor on pin", pin);
+    return true;
+}
+
+void IRAM_ATTR TraySensorController::edgeISR() {
+    if (instance) {
+        instance->recordEdge();
+    }
+}
+
+void IRAM_ATTR TraySensorController::recordEdge() {
+    uint32_t now = micros();
+    bool present = (digitalRead(pin) == LOW);
+
+    portENTER_CRITICAL_ISR(&mux);
+    uint8_t next = (head + 1) % EDGE_BUFFER_SIZE;
+    if (next == tail) {
+        // Loop fell behind - drop this edge, update() resyncs from the pin level
+        overruns++;
+    } else {
+        edgeTimes[head] = now;
+        edgeLevels[head] = present;
+        head = next;
+    }
+    portEXIT_CRITICAL_ISR(&mux);
+}
+
+void TraySensorController::update() {
+    if (!initialized) return;
+
+    // Drain timestamped edges in order
+    while (true) {
+        bool present;
+        uint32_t timeUs;
+
+        portENTER_CRITICAL(&mux);
+        if (head == tail) {
+            portEXIT_CRITICAL(&mux);
+            break;
+        }
+        timeUs = edgeTimes[tail];
+        present = edgeLevels[tail];
+        tail = (tail + 1) % EDGE_BUFFER_SIZE;
+        portEXIT_CRITICAL(&mux);
+
+        processEdge(present, timeUs);
+    }
+
+    // Edge lost to a buffer overrun - fall back to the pin level
+    bool level = (digitalRead(pin) == LOW);
+    if (!hasPending && level != trayPresent) {
+        hasPending = true;
+        pendingPresent = level;
+        pendingTime = micros();
+    }
+
+    // Pending edge held long enough with no bounce - it is real
+    if (hasPending && micros() - pendingTime >= debounceTime && level == pendingPresent) {
+        hasPending = false;
+        confirmEdge(pendingPresent, pendingTime);
+    }
+}
+
+void TraySensorController::processEdge(bool present, uint32_t timeUs) {
+    if (!hasPending) {
+        if (present != trayPresent) {
+            hasPending = true;
+            pendingPresent = present;
+            pendingTime = timeUs;
+        }
+        return;
+    }
+
+    if (present == pendingPresent) {
+        // Repeated level - keep the earliest timestamp (a resync may have guessed later)
+        if ((int32_t)(timeUs - pendingTime) < 0) {
+            pendingTime = timeUs;
+        }
+        return;
+    }
+
+    if (timeUs - pendingTime < debounceTime) {
+        // Bounced back before the debounce time - discard the pending edge
+        hasPending = false;
+        glitchCount++;
+        return;
+    }
+
+    // Pending edge held long enough before this one - confirm it, then track the new edge
+    confirmEdge(pendingPresent, pendingTime);
+    hasPending = (present != trayPresent);
+    pendingPresent = present;
+    pendingTime = timeUs;
+}
+
+void TraySensorController::confirmEdge(bool present, uint32_t timeUs) {
+    if (present == trayPresent) return;
+    trayPresent = present;
+
+    if (present) {
+        // Leading edge - new tray
+        trayCount++;
+        if (hasTrailing) {
+            trayGapUs = timeUs - lastTrailing;
+        }
+        if (hasLeading) {
+            trayPitchUs = timeUs - lastLeading;
+            avgPitchUs = (avgPitchUs == 0) ? trayPitchUs : avgPitchUs + (trayPitchUs - avgPitchUs) * 0.25f;
+        }
+        lastLeading = timeUs;
+        hasLeading = true;
+
+        logger.verbose("Tray", "Tray arrived, count", (int)trayCount);
+        if (eventCallback) {
+            eventCallback(TRAY_EVENT_ARRIVED);
+        }
+    } else {
+        // Trailing edge - tray cleared the beam
+        if (hasLeading) {
+            trayLengthUs = timeUs - lastLeading;
+        }
+        lastTrailing = timeUs;
+        hasTrailing = true;
+
+        if (eventCallback) {
+            eventCallback(TRAY_EVENT_LEFT);
+        }
+    }
+}
+
+void TraySensorController::resetCount() {
+    trayCount = 0;
+    hasLeading = false;
+    hasTrailing = false;
+    avgPitchUs = 0;
+    trayPitchUs = 0;
+    trayGapUs = 0;
+}
+
+float TraySensorController::getTraysPerMinute() {
+    if (avgPitchUs <= 0 || !hasLeading) return 0;
+
+    // Line stopped - no tray for three average pitches
+    if (micros() - lastLeading > avgPitchUs * 3) return 0;
+
+    return 60000000.0f / avgPitchUs;
+}
+
+void TraySensorController::logStatistics() {
+    if (!initialized) return;
+
+    logger.debug("Tray", "Tray count", (int)trayCount);
+    logger.debug("Tray", "Trays per minute", (int)getTraysPerMinute());
+    logger.debug("Tray", "Tray length (ms)", (int)getTrayLengthMs());
+    logger.debug("Tray", "Tray gap (ms)", (int)getTrayGapMs());
+    if (glitchCount > 0 || overruns > 0) {
+        logger.debug("Tray", "Glitches", (int)glitchCount);
+        logger.debug("Tray", "Overruns", (int)overruns);
+    }
+}
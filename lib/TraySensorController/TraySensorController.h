@@ -0,0 +1,96 @@
+/*
+ * Tray Sensor Controller
+ * IR tray detector on a GPIO edge interrupt
+ *
+ * The ISR only timestamps edges into a ring buffer; debouncing, tray
+ * counting and timing run in update(). Active LOW (LOW = tray present).
+ */
+
+#ifndef TRAYSENSORCONTROLLER_H
+#define TRAYSENSORCONTROLLER_H
+
+#include <Arduino.h>
+
+enum TrayEvent {
+    TRAY_EVENT_ARRIVED,           // Leading edge - tray reached the sensor
+    TRAY_EVENT_LEFT               // Trailing edge - tray cleared the sensor
+};
+
+class TraySensorController {
+public:
+    static const uint8_t EDGE_BUFFER_SIZE = 16;
+
+    TraySensorController();
+
+    // Initialization
+    bool init(uint8_t pin);
+    void setDebounce(uint32_t debounceUs) { debounceTime = debounceUs; }
+
+    // Process buffered edges (call in loop)
+    void update();
+
+    // Event callback (called from update(), not from the ISR)
+    void setEventCallback(void (*callback)(TrayEvent event)) { eventCallback = callback; }
+
+    // Tray state and counters - pollers compare getTrayCount() with their last value
+    bool isTrayPresent() { return trayPresent; }
+    uint32_t getTrayCount() { return trayCount; }
+    void resetCount();
+
+    // Timing (leading/trailing edges, ISR timestamped)
+    uint32_t getLastLeadingEdge() { return lastLeading; }      // micros()
+    uint32_t getLastTrailingEdge() { return lastTrailing; }    // micros()
+    uint32_t getTrayLengthMs() { return trayLengthUs / 1000; } // Time the last tray blocked the beam
+    uint32_t getTrayGapMs() { return trayGapUs / 1000; }       // Clear beam before the last tray
+    uint32_t getTrayPitchMs() { return trayPitchUs / 1000; }   // Leading edge to leading edge
+    float getTraysPerMinute();
+
+    // Diagnostics
+    uint32_t getGlitchCount() { return glitchCount; }
+    uint32_t getOverruns() { return overruns; }
+    void logStatistics();
+
+private:
+    uint8_t pin;
+    bool initialized;
+    uint32_t debounceTime;                   // us an edge must hold to count
+
+    // ISR -> loop edge buffer
+    volatile uint32_t edgeTimes[EDGE_BUFFER_SIZE];
+    volatile bool edgeLevels[EDGE_BUFFER_SIZE];   // true = tray present
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint32_t overruns;
+    portMUX_TYPE mux;
+
+    // Debounced state
+    bool trayPresent;
+    bool hasPending;
+    bool pendingPresent;
+    uint32_t pendingTime;
+    uint32_t glitchCount;
+
+    // Counting and timing
+    uint32_t trayCount;
+    bool hasLeading;
+    bool hasTrailing;
+    uint32_t lastLeading;
+    uint32_t lastTrailing;
+    uint32_t trayLengthUs;
+    uint32_t trayGapUs;
+    uint32_t trayPitchUs;
+    float avgPitchUs;                        // Smoothed pitch for throughput
+
+    void (*eventCallback)(TrayEvent event);
+
+    static const uint32_t DEFAULT_DEBOUNCE_US = 5000;
+
+    static TraySensorController* instance;   // Single tray sensor per machine
+    static void IRAM_ATTR edgeISR();
+    void IRAM_ATTR recordEdge();
+
+    void processEdge(bool present, uint32_t timeUs);
+    void confirmEdge(bool present, uint32_t timeUs);
+};
+
+#endif // TRAYSENSORCONTROLLER_H
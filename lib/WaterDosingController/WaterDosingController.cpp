@@ -0,0 +1,295 @@
+/*
+ * Water Dosing Controller Implementation
+ */
+
+#include "WaterDosingController.h"
+#include <Preferences.h>
+#include <LogController.h>
+
+extern Preferences preferences;
+extern LogController logger;
+
+WaterDosingController::WaterDosingController() {
+    flowMeter = nullptr;
+    valveRelay = 0;
+    relayControl = nullptr;
+    state = DOSING_IDLE;
+    targetMl = 0;
+    tolerancePercent = 1.0;
+    startTime = 0;
+    stateStart = 0;
+    valveOpen = false;
+    closeVolume = 0;
+    closeRate = 0;
+    pulseCount = 0;
+    pulseLength = 0;
+    pulseStartVolume = 0;
+    afterFlowLag = DEFAULT_LAG;
+    pulseGain = 0;
+    lagLearned = false;
+    savedLag = DEFAULT_LAG;
+    savedPulseGain = 0;
+    memset(&lastResult, 0, sizeof(lastResult));
+}
+
+void WaterDosingController::init(FlowMeterController* meter, uint8_t relay,
+                                 void (*relayCallback)(uint8_t relayIndex, bool state)) {
+    flowMeter = meter;
+    valveRelay = relay;
+    relayControl = relayCallback;
+
+    loadLearning();
+    logger.info("Water", "After-flow lag (ms)", (int)afterFlowLag);
+}
+
+bool WaterDosingController::start(float target) {
+    if (flowMeter == nullptr || !flowMeter->isConnected()) {
+        logger.error("Water", "Flow meter not available!");
+        return false;
+    }
+    if (isActive()) {
+        logger.warning("Water", "Dose already running");
+        return false;
+    }
+    if (target <= 0) {
+        logger.error("Water", "Invalid dose target!");
+        return false;
+    }
+
+    targetMl = target;
+    pulseCount = 0;
+    closeVolume = 0;
+    closeRate = 0;
+    startTime = millis();
+    memset(&lastResult, 0, sizeof(lastResult));
+
+    logger.info("Water", "Dosing (ml)", (int)targetMl);
+    flowMeter->startBatch();
+    setValve(true);
+    enterState(DOSING_FILLING);
+    return true;
+}
+
+void WaterDosingController::abort() {
+    if (!isActive()) return;
+
+    setValve(false);
+    flowMeter->stopBatch();
+    logger.warning("Water", "Dosing aborted");
+    enterState(DOSING_FAILED);
+}
+
+void WaterDosingController::acknowledge() {
+    if (state == DOSING_DONE || state == DOSING_FAILED) {
+        state = DOSING_IDLE;
+    }
+}
+
+void WaterDosingController::update() {
+    if (!isActive()) return;
+
+    unsigned long now = millis();
+
+    // Supply failure while the valve is commanded open
+    if (valveOpen && flowMeter->isNoFlowTimeout()) {
+        logger.error("Water", "No flow - check water supply");
+        finish(false);
+        return;
+    }
+
+    switch (state) {
+        case DOSING_FILLING: {
+            // Close early by what will still arrive during the valve latency
+            float delivered = getDeliveredMl();
+            float rate = flowMeter->getFlowRateMlPerSec();
+            float mainTarget = targetMl * (1.0f - TOPUP_FRACTION);
+            float anticipation = rate * afterFlowLag / 1000.0f;
+
+            if (delivered + anticipation >= mainTarget) {
+                setValve(false);
+                closeVolume = delivered;
+                closeRate = rate;
+                enterState(DOSING_AFTERFLOW);
+            }
+            break;
+        }
+
+        case DOSING_AFTERFLOW:
+            if (flowSettled()) {
+                afterMainFill();
+            }
+            break;
+
+        case DOSING_PULSE:
+            if (now - stateStart >= pulseLength) {
+                setValve(false);
+                enterState(DOSING_PULSE_SETTLE);
+            }
+            break;
+
+        case DOSING_PULSE_SETTLE:
+            if (flowSettled()) {
+                float delivered = getDeliveredMl();
+                float pulseVolume = delivered - pulseStartVolume;
+
+                if (pulseVolume > 0) {
+                    float gain = pulseVolume / pulseLength;
+                    pulseGain += (gain - pulseGain) * 0.5f;
+                } else {
+                    // Pulse shorter than the valve dead time - lengthen the next one
+                    pulseGain *= 0.5f;
+                }
+
+                if (delivered >= targetMl - toleranceMl()) {
+                    finish(true);
+                } else {
+                    startPulse();
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool WaterDosingController::flowSettled() {
+    unsigned long inState = millis() - stateStart;
+    if (inState < SETTLE_TIME) return false;
+
+    // A weeping valve never goes fully quiet - give up waiting eventually
+    return flowMeter->getTimeSinceLastPulse() >= SETTLE_TIME || inState >= MAX_SETTLE_TIME;
+}
+
+void WaterDosingController::afterMainFill() {
+    float delivered = getDeliveredMl();
+    float afterFlow = delivered - closeVolume;
+    lastResult.afterFlowMl = afterFlow;
+
+    // Learn the lag from this batch; first measurement replaces the default
+    if (closeRate > 0 && afterFlow >= 0) {
+        float measuredLag = afterFlow / closeRate * 1000.0f;
+        if (measuredLag > MAX_LAG) measuredLag = MAX_LAG;
+
+        if (lagLearned) {
+            afterFlowLag += (measuredLag - afterFlowLag) * 0.25f;
+        } else {
+            afterFlowLag = measuredLag;
+            lagLearned = true;
+        }
+    }
+
+    // First estimate of the pulse size from the main fill rate
+    if (pulseGain <= 0 && closeRate > 0) {
+        pulseGain = closeRate / 1000.0f;
+    }
+
+    if (delivered >= targetMl - toleranceMl()) {
+        finish(true);
+    } else {
+        startPulse();
+    }
+}
+
+void WaterDosingController::startPulse() {
+    if (pulseCount >= MAX_PULSES) {
+        logger.warning("Water", "Top-up pulse limit reached");
+        finish(true);
+        return;
+    }
+
+    float remaining = targetMl - getDeliveredMl();
+    float gain = (pulseGain > 0) ? pulseGain : 0.01f;
+    unsigned long length = (unsigned long)(remaining * PULSE_UNDERSHOOT / gain);
+    if (length < MIN_PULSE) length = MIN_PULSE;
+    if (length > MAX_PULSE) length = MAX_PULSE;
+
+    pulseLength = length;
+    pulseStartVolume = getDeliveredMl();
+    pulseCount++;
+    setValve(true);
+    enterState(DOSING_PULSE);
+}
+
+void WaterDosingController::finish(bool success) {
+    setValve(false);
+    flowMeter->stopBatch();
+
+    lastResult.targetMl = targetMl;
+    lastResult.deliveredMl = flowMeter->getBatchVolumeMl();
+    lastResult.errorMl = lastResult.deliveredMl - targetMl;
+    lastResult.pulses = pulseCount;
+    lastResult.fillTimeMs = millis() - startTime;
+
+    logger.info("Water", "Dose delivered (ml)", (int)lastResult.deliveredMl);
+    logger.info("Water", "Dose error (0.1ml)", (int)(lastResult.errorMl * 10));
+    logger.info("Water", "Dose error (0.1%)", (int)(lastResult.errorMl * 1000 / targetMl));
+    logger.info("Water", "After-flow (ml)", (int)lastResult.afterFlowMl);
+    logger.info("Water", "Top-up pulses", (int)pulseCount);
+    logger.info("Water", "Fill time (ms)", (int)lastResult.fillTimeMs);
+
+    if (success && fabs(lastResult.errorMl) > toleranceMl()) {
+        logger.warning("Water", "Dose outside tolerance");
+    }
+
+    // Persist learning only when it moved noticeably (flash wear)
+    if (fabs(afterFlowLag - savedLag) > 10.0f ||
+        fabs(pulseGain - savedPulseGain) > savedPulseGain * 0.05f) {
+        saveLearning();
+    }
+
+    enterState(success ? DOSING_DONE : DOSING_FAILED);
+}
+
+float WaterDosingController::getDeliveredMl() {
+    return flowMeter ? flowMeter->getBatchVolumeMl() : 0.0f;
+}
+
+uint8_t WaterDosingController::getProgress() {
+    if (state == DOSING_DONE) return 100;
+    if (targetMl <= 0) return 0;
+
+    float percent = getDeliveredMl() * 100.0f / targetMl;
+    return (percent >= 100) ? 100 : (uint8_t)percent;
+}
+
+float WaterDosingController::toleranceMl() {
+    return targetMl * tolerancePercent / 100.0f;
+}
+
+void WaterDosingController::setValve(bool open) {
+    valveOpen = open;
+    if (relayControl) {
+        relayControl(valveRelay, open);
+    }
+}
+
+void WaterDosingController::enterState(DosingState newState) {
+    state = newState;
+    stateStart = millis();
+}
+
+void WaterDosingController::loadLearning() {
+    afterFlowLag = preferences.getFloat("doseLag", NAN);
+    pulseGain = preferences.getFloat("doseGain", 0);
+
+    lagLearned = !isnan(afterFlowLag);
+    if (!lagLearned || afterFlowLag < 0 || afterFlowLag > MAX_LAG) {
+        afterFlowLag = DEFAULT_LAG;
+        lagLearned = false;
+    }
+    if (isnan(pulseGain) || pulseGain < 0) {
+        pulseGain = 0;
+    }
+
+    savedLag = afterFlowLag;
+    savedPulseGain = pulseGain;
+}
+
+void WaterDosingController::saveLearning() {
+    preferences.putFloat("doseLag", afterFlowLag);
+    preferences.putFloat("doseGain", pulseGain);
+    savedLag = afterFlowLag;
+    savedPulseGain = pulseGain;
+    logger.debug("Water", "Dosing learning saved");
+}
@@ -0,0 +1,115 @@
+/*
+ * Water Dosing Controller
+ * Closed-loop fill through the water valve, metered by the flow meter
+ *
+ * The valve is closed early by the learned after-flow (valve and relay
+ * latency), the last few percent are delivered in learned-size pulses.
+ * Non-blocking - call update() in loop.
+ */
+
+#ifndef WATERDOSINGCONTROLLER_H
+#define WATERDOSINGCONTROLLER_H
+
+#include <Arduino.h>
+#include <FlowMeterController.h>
+
+enum DosingState {
+    DOSING_IDLE,
+    DOSING_FILLING,           // Valve open, full flow
+    DOSING_AFTERFLOW,         // Valve closed, measuring the after-flow
+    DOSING_PULSE,             // Top-up pulse, valve open
+    DOSING_PULSE_SETTLE,      // Waiting for the pulse to finish flowing
+    DOSING_DONE,
+    DOSING_FAILED             // No flow or aborted
+};
+
+// Summary of the last completed dose
+struct DosingResult {
+    float targetMl;
+    float deliveredMl;
+    float errorMl;            // Delivered - target
+    float afterFlowMl;        // Measured after the main close
+    uint8_t pulses;           // Top-up pulses used
+    unsigned long fillTimeMs;
+};
+
+class WaterDosingController {
+public:
+    WaterDosingController();
+
+    // Initialization - relayControl switches the valve relay (setRelay)
+    void init(FlowMeterController* meter, uint8_t valveRelay,
+              void (*relayControl)(uint8_t relayIndex, bool state));
+
+    // Dosing control
+    bool start(float targetMl);
+    void abort();
+    void update();
+
+    // Status
+    DosingState getState() { return state; }
+    bool isActive() { return state != DOSING_IDLE && state != DOSING_DONE && state != DOSING_FAILED; }
+    bool isDone() { return state == DOSING_DONE; }
+    bool isFailed() { return state == DOSING_FAILED; }
+    void acknowledge();                           // DONE/FAILED -> IDLE
+    float getDeliveredMl();
+    uint8_t getProgress();                        // 0-100
+    const DosingResult& getLastResult() { return lastResult; }
+
+    // Learned valve behaviour (stored in Preferences)
+    float getAfterFlowLagMs() { return afterFlowLag; }
+    float getPulseGain() { return pulseGain; }    // ml per ms of valve open time
+    void setTolerance(float percent) { tolerancePercent = percent; }
+    void loadLearning();
+    void saveLearning();
+
+private:
+    FlowMeterController* flowMeter;
+    uint8_t valveRelay;
+    void (*relayControl)(uint8_t relayIndex, bool state);
+
+    DosingState state;
+    float targetMl;
+    float tolerancePercent;
+    unsigned long startTime;
+    unsigned long stateStart;
+    bool valveOpen;
+
+    // Main fill close point
+    float closeVolume;
+    float closeRate;                              // ml/s when the valve was closed
+
+    // Top-up pulses
+    uint8_t pulseCount;
+    unsigned long pulseLength;
+    float pulseStartVolume;
+
+    // Learned after-flow, expressed as a lag so it scales with the flow rate
+    float afterFlowLag;                           // ms of flow still arriving after close
+    float pulseGain;                              // ml per ms of pulse
+    bool lagLearned;                              // At least one after-flow measured
+    float savedLag;
+    float savedPulseGain;
+
+    DosingResult lastResult;
+
+    static const unsigned long SETTLE_TIME = 400;     // No pulses this long = flow has stopped
+    static const unsigned long MAX_SETTLE_TIME = 5000;
+    static const unsigned long MIN_PULSE = 40;        // ms
+    static const unsigned long MAX_PULSE = 1500;      // ms
+    static const uint8_t MAX_PULSES = 12;
+    static constexpr float TOPUP_FRACTION = 0.03f;    // Last 3% delivered in pulses
+    static constexpr float DEFAULT_LAG = 250.0f;      // ms
+    static constexpr float MAX_LAG = 3000.0f;         // ms
+    static constexpr float PULSE_UNDERSHOOT = 0.8f;   // Aim pulses short, never overshoot on one pulse
+
+    void setValve(bool open);
+    void enterState(DosingState newState);
+    bool flowSettled();
+    void afterMainFill();
+    void startPulse();
+    void finish(bool success);
+    float toleranceMl();
+};
+
+#endif // WATERDOSINGCONTROLLER_H
@@ -7,7 +7,8 @@
 MenuItem mainMenuItems[MAIN_MENU_COUNT] = {
     {"Settings", MENU_ITEM_SUBMENU, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Run Auto", MENU_ITEM_ACTION, startAutoRun, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
-    {"Test Machine", MENU_ITEM_SUBMENU, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
+    {"Test Machine", MENU_ITEM_SUBMENU, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Recipe", MENU_ITEM_ACTION, selectNextRecipe, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
 };
 
 // Settings submenu items
@@ -19,6 +20,8 @@ MenuItem settingsMenuItems[SETTINGS_MENU_COUNT] = {
     {"Moulding", MENU_ITEM_SUBMENU, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Drying", MENU_ITEM_SUBMENU, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Scale Calibrate", MENU_ITEM_SUBMENU, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Conveyor", MENU_ITEM_SUBMENU, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Save Recipe", MENU_ITEM_ACTION, saveCustomRecipe, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Save All", MENU_ITEM_ACTION, saveSettings, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Back", MENU_ITEM_BACK, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
 };
@@ -27,6 +30,9 @@ MenuItem settingsMenuItems[SETTINGS_MENU_COUNT] = {
 MenuItem waterMenuItems[WATER_MENU_COUNT] = {
     {"Amount", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &waterAmount, nullptr, nullptr, 100, 5000, 50, "ml", "waterAmt"},
     {"Timeout", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &waterFlowTimeout, nullptr, nullptr, 10, 300, 5, "sec", "waterTmo"},
+    {"Dose Now", MENU_ITEM_ACTION, startWaterDose, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Cal Amount", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &flowCalAmount, nullptr, nullptr, 200, 5000, 100, "g", "flowCalG"},
+    {"Cal Flow K", MENU_ITEM_ACTION, calibrateFlowMeter, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Back", MENU_ITEM_BACK, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
 };
 
@@ -47,6 +53,7 @@ MenuItem shredderMenuItems[SHREDDER_MENU_COUNT] = {
 MenuItem mixerMenuItems[MIXER_MENU_COUNT] = {
     {"Mix Time", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &mixTime, nullptr, nullptr, 30, 600, 10, "sec", "mixTm"},
     {"Mix Speed", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &mixSpeed, nullptr, nullptr, 0, 100, 5, "%", "mixSpd"},
+    {"Auto Mix End", MENU_ITEM_BOOL, nullptr, nullptr, 0, nullptr, nullptr, &mixAutoEnd, 0, 0, 0, nullptr, "mixAuto"},
     {"Back", MENU_ITEM_BACK, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
 };
 
@@ -55,6 +62,8 @@ MenuItem mouldingMenuItems[MOULDING_MENU_COUNT] = {
     {"Suction Time", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &mouldSuctionTime, nullptr, nullptr, 3, 30, 1, "sec", "mldSucTm"},
     {"Blower Time", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &mouldBlowerTime, nullptr, nullptr, 2, 20, 1, "sec", "mldBlwTm"},
     {"Cycle Delay", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &mouldCycleDelay, nullptr, nullptr, 1, 10, 1, "sec", "mldDly"},
+    {"Dual Mould", MENU_ITEM_BOOL, nullptr, nullptr, 0, nullptr, nullptr, &dualMould, 0, 0, 0, nullptr, "dualMld"},
+    {"Auto Suction", MENU_ITEM_BOOL, nullptr, nullptr, 0, nullptr, nullptr, &suctionAutoEnd, 0, 0, 0, nullptr, "sucAuto"},
     {"Back", MENU_ITEM_BACK, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
 };
 
@@ -62,6 +71,16 @@ MenuItem mouldingMenuItems[MOULDING_MENU_COUNT] = {
 MenuItem dryingMenuItems[DRYING_MENU_COUNT] = {
     {"Dry Time", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &dryingTime, nullptr, nullptr, 60, 600, 30, "sec", "dryTm"},
     {"Temperature", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &dryingTemp, nullptr, nullptr, 50, 120, 5, "C", "dryTemp"},
+    {"Auto-Tune", MENU_ITEM_ACTION, heaterAutoTune, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Back", MENU_ITEM_BACK, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
+};
+
+// Conveyor and reject station settings submenu
+MenuItem conveyorMenuItems[CONVEYOR_MENU_COUNT] = {
+    {"Speed", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &conveyorSpeed, nullptr, nullptr, 0, 100, 5, "%", "convSpd"},
+    {"Reject 1 Dist", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &rejectDistance1, nullptr, nullptr, 100, 30000, 100, "ms", "rejDist1"},
+    {"Reject 2 Dist", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &rejectDistance2, nullptr, nullptr, 100, 30000, 100, "ms", "rejDist2"},
+    {"Reject Pulse", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &rejectPulseTime, nullptr, nullptr, 50, 2000, 50, "ms", "rejPulse"},
     {"Back", MENU_ITEM_BACK, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
 };
 
@@ -70,6 +89,15 @@ MenuItem scaleCalMenuItems[SCALE_CAL_MENU_COUNT] = {
     {"Cal Weight", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &scaleCalibrationWeight, nullptr, nullptr, 100, 5000, 50, "g", "scaleCalWt"},
     {"Zero Scale", MENU_ITEM_ACTION, calibrateScaleZero, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Calibrate", MENU_ITEM_ACTION, calibrateScaleWithWeight, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Add Point", MENU_ITEM_ACTION, calibrateScaleAddPoint, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Temp Comp", MENU_ITEM_BOOL, nullptr, nullptr, 0, nullptr, nullptr, &scaleTempComp, 0, 0, 0, nullptr, "scaleTmpCmp"},
+    {"Zero Track", MENU_ITEM_BOOL, nullptr, nullptr, 0, nullptr, nullptr, &scaleZeroTrack, 0, 0, 0, nullptr, "scaleZTrk"},
+    {"Track Band", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &scaleZeroBand, nullptr, nullptr, 1, 20, 1, "g", "scaleZBand"},
+    {"Track Limit", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &scaleZeroLimit, nullptr, nullptr, 5, 200, 5, "g", "scaleZLim"},
+    {"Tank Cell", MENU_ITEM_BOOL, nullptr, nullptr, 0, nullptr, nullptr, &tankScaleEnabled, 0, 0, 0, nullptr, "tankEn"},
+    {"Tank Cal Wt", MENU_ITEM_VALUE_INT, nullptr, nullptr, 0, &tankCalibrationWeight, nullptr, nullptr, 1000, 50000, 500, "g", "tankCalWt"},
+    {"Tank Zero", MENU_ITEM_ACTION, calibrateTankZero, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Tank Cal", MENU_ITEM_ACTION, calibrateTankWithWeight, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Back", MENU_ITEM_BACK, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr}
 };
 
@@ -82,6 +110,7 @@ MenuItem testMenuItems[TEST_MENU_COUNT] = {
     {"Pump", MENU_ITEM_ACTION, toggleRelay9, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Screw", MENU_ITEM_ACTION, toggleRelay6, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Conveyor", MENU_ITEM_ACTION, toggleRelay5, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
+    {"Shredder Rev", MENU_ITEM_ACTION, toggleShredderReverse, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Shredder Trigger", MENU_ITEM_ACTION, toggleRelay12, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Linear Door", MENU_ITEM_ACTION, toggleRelay2, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
     {"Vacuum", MENU_ITEM_ACTION, toggleRelay16, nullptr, 0, nullptr, nullptr, nullptr, 0, 0, 0, nullptr, nullptr},
@@ -113,6 +142,7 @@ MenuLayer menuLayers[TOTAL_LAYERS] = {
     {"MOULDING", mouldingMenuItems, MOULDING_MENU_COUNT},
     {"DRYING", dryingMenuItems, DRYING_MENU_COUNT},
     {"SCALE CALIBRATE", scaleCalMenuItems, SCALE_CAL_MENU_COUNT},
+    {"CONVEYOR", conveyorMenuItems, CONVEYOR_MENU_COUNT},
     {"TEST MACHINE", testMenuItems, TEST_MENU_COUNT},
     {"RUNNING", runningMenuItems, RUNNING_MENU_COUNT}
 };
@@ -148,4 +178,7 @@ void linkMenus() {
     
     settingsMenuItems[6].subMenu = scaleCalMenuItems;
     settingsMenuItems[6].subMenuSize = SCALE_CAL_MENU_COUNT;
+    
+    settingsMenuItems[7].subMenu = conveyorMenuItems;
+    settingsMenuItems[7].subMenuSize = CONVEYOR_MENU_COUNT;
 }
@@ -0,0 +1,64 @@
+#include "RecipeConfig.h"
+#include "SettingsConfig.h"
+#include "PCF8575_PinMap.h"
+
+// ==================== SETTINGS SOURCES ====================
+
+const int* const recipeSettings[RECIPE_SET_COUNT] = {
+    nullptr,                // Fixed value
+    &waterAmount,
+    &starchWeight,
+    &shredderTime,
+    &mixTime,
+    &pumpTime,
+    &mouldSuctionTime,
+    &dryingTime
+};
+
+// ==================== RELAY FRAMES ====================
+
+#define FRAME_SHREDDER  (RECIPE_RELAY(RELAY_IDX_SHREDDER_MAIN_POWER) | RECIPE_RELAY(RELAY_IDX_SHREDDER_POWER))
+#define FRAME_MIXER     RECIPE_RELAY(RELAY_IDX_MIXER)
+#define FRAME_PUMP      RECIPE_RELAY(RELAY_IDX_PUMP)
+#define FRAME_CONVEYOR  RECIPE_RELAY(RELAY_IDX_CONVEYOR)
+
+// Step fields: name, relay frame, end condition, value source, value, timeout (s), next, flags
+
+// Prep lane: fill the vat for the next batch
+#define PREP_STEPS(water, starch, shred, mix, src) \
+    {"Wait Vat",   0,              RECIPE_END_VAT_EMPTY, RECIPE_SET_FIXED,                         0,      0, 1, RECIPE_FLAG_NEW_BATCH}, \
+    {"Water Fill", 0,              RECIPE_END_WATER,     (src) ? RECIPE_SET_WATER_AMOUNT  : 0,     water,  0, 2, RECIPE_FLAG_VAT}, \
+    {"Starch",     0,              RECIPE_END_STARCH,    (src) ? RECIPE_SET_STARCH_WEIGHT : 0,     starch, 0, 3, RECIPE_FLAG_VAT}, \
+    {"Shredding",  FRAME_SHREDDER, RECIPE_END_SHRED,     (src) ? RECIPE_SET_SHREDDER_TIME : 0,     shred,  0, 4, RECIPE_FLAG_VAT}, \
+    {"Mixing",     FRAME_MIXER,    RECIPE_END_MIX,       (src) ? RECIPE_SET_MIX_TIME      : 0,     mix,    0, RECIPE_NEXT_END, \
+                                                                                                   RECIPE_FLAG_VAT | RECIPE_FLAG_VAT_FILLED}
+
+// Mould lane: pump, mould, dry and convey the previous batch
+#define MOULD_STEPS(pump, suction, dry, src) \
+    {"Wait Pulp",  0,              RECIPE_END_VAT_FULL,  RECIPE_SET_FIXED,                         0,       0, 1, 0}, \
+    {"Pumping",    FRAME_PUMP,     RECIPE_END_TIME,      (src) ? RECIPE_SET_PUMP_TIME     : 0,     pump,    0, 2, \
+                                                                                                   RECIPE_FLAG_VAT | RECIPE_FLAG_VAT_DRAINED}, \
+    {"Moulding",   0,              RECIPE_END_MOULD,     (src) ? RECIPE_SET_MOULD_SUCTION : 0,     suction, 0, 3, 0}, \
+    {"Drying",     0,              RECIPE_END_DRY,       (src) ? RECIPE_SET_DRYING_TIME   : 0,     dry,     0, 4, RECIPE_FLAG_NEEDS_TRAY}, \
+    {"Conveyor",   FRAME_CONVEYOR, RECIPE_END_TRAY,      RECIPE_SET_FIXED,                         0,       0, RECIPE_NEXT_END, \
+                                                                                                   RECIPE_FLAG_NEEDS_TRAY}
+
+// ==================== BUILT-IN RECIPES ====================
+
+const Recipe builtInRecipes[BUILTIN_RECIPE_COUNT] = {
+    // Follows the Settings menu values
+    {RECIPE_FORMAT_VERSION, "Settings", {5, 5}, {
+        {PREP_STEPS(0, 0, 0, 0, true)},
+        {MOULD_STEPS(0, 0, 0, true)}
+    }},
+    // 30-cell egg tray
+    {RECIPE_FORMAT_VERSION, "30-Cell", {5, 5}, {
+        {PREP_STEPS(1000, 500, 30, 120, false)},
+        {MOULD_STEPS(45, 8, 300, false)}
+    }},
+    // 12-cell egg tray - smaller pulp batch, thinner wall
+    {RECIPE_FORMAT_VERSION, "12-Cell", {5, 5}, {
+        {PREP_STEPS(500, 250, 20, 90, false)},
+        {MOULD_STEPS(25, 6, 240, false)}
+    }}
+};
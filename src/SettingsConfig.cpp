@@ -3,6 +3,7 @@
 // ==================== WATER SETTINGS ====================
 int waterAmount = 1000;          // ml
 int waterFlowTimeout = 60;       // seconds
+int flowCalAmount = 1000;        // grams - water weighed for K-factor calibration
 
 // ==================== STARCH SETTINGS ====================
 int starchWeight = 500;          // grams
@@ -14,6 +15,7 @@ int shredderTime = 30;           // seconds
 // ==================== MIXER SETTINGS ====================
 int mixTime = 120;               // seconds
 int mixSpeed = 100;              // percentage
+bool mixAutoEnd = true;          // Current end-point, mix time = upper bound
 
 // ==================== PULP PUMP ====================
 int pumpTime = 45;               // seconds
@@ -22,6 +24,8 @@ int pumpTime = 45;               // seconds
 int mouldSuctionTime = 8;        // seconds
 int mouldBlowerTime = 5;         // seconds
 int mouldCycleDelay = 2;         // seconds
+bool dualMould = false;          // Mould A/B ping-pong
+bool suctionAutoEnd = true;      // Vacuum end-point, suction time = upper bound
 
 // ==================== DRYING SETTINGS ====================
 int dryingTime = 300;            // seconds
@@ -29,9 +33,18 @@ int dryingTemp = 80;             // degrees C
 
 // ==================== CONVEYOR ====================
 int conveyorSpeed = 50;          // percentage
+int rejectDistance1 = 3000;      // ms of conveyor run from IR sensor to Defective 1
+int rejectDistance2 = 5000;      // ms of conveyor run from IR sensor to Defective 2
+int rejectPulseTime = 300;       // ms reject relay on time
 
 // ==================== SCALE CALIBRATION ====================
 int scaleCalibrationWeight = 500; // grams - known weight for calibration
+bool scaleTempComp = false;        // NAU7802 temperature drift compensation
+bool scaleZeroTrack = true;        // Automatic zero tracking while idle
+int scaleZeroBand = 2;             // grams - track only within +/- band of zero
+int scaleZeroLimit = 20;           // grams - max total tracked correction
+bool tankScaleEnabled = false;     // Pulp tank load cell on NAU7802 channel 2
+int tankCalibrationWeight = 10000; // grams - known weight for tank calibration
 
 // ==================== SYSTEM STATE ====================
 bool testMode = false;
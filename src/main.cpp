@@ -9,9 +9,10 @@
  * - 1x 16-channel Relay Board (via PCF8575 #1)
  * - 1x 8-channel Relay Board (via PCF8575 #2)
  * - 3x Buttons: Enter, Up, Down (via PCF8575 #2)
- * - Water Flow Sensor (via PCF8575 #2)
+ * - Water Flow Sensor (GPIO, ESP32 pulse counter)
  * - Servo Motor (Starch Discharge)
- * - Load Cell (HX711 amplifier)
+ * - Load Cell (NAU7802 or HX711 amplifier)
+ * - IR Tray Sensor (GPIO edge interrupt)
  * 
  * Features:
  * - Non-blocking operation
@@ -31,6 +32,7 @@
 #include "PCF8575_PinMap.h"
 #include "SettingsConfig.h"
 #include "MenuConfig.h"
+#include "RecipeConfig.h"
 
 // Controller includes
 #include <ButtonController.h>
@@ -38,6 +40,21 @@
 #include <DisplayController.h>
 #include <LogController.h>
 #include <ScaleController.h>
+#include <FlowMeterController.h>
+#include <FlowKCalibration.h>
+#include <WaterDosingController.h>
+#include <TraySensorController.h>
+#include <RejectController.h>
+#include <SequencerController.h>
+#include <MouldScheduler.h>
+#include <SuctionMonitor.h>
+#include <MotorMonitor.h>
+#include <DutyCycleScheduler.h>
+#include <PowerBudget.h>
+#include <RecipeEngine.h>
+#include <CycleProfiler.h>
+#include <AdcScanController.h>
+#include <HeaterController.h>
 
 // ==================== GLOBAL OBJECTS ====================
 
@@ -45,8 +62,71 @@ ButtonController buttonController;
 MenuController menuController;
 DisplayController displayController;
 ScaleController scaleController;
+FlowMeterController flowMeter;
+WaterDosingController waterDosing;
+TraySensorController traySensor;
+RejectController rejectController;
+ResourceArbiter resourceArbiter;
+SequencerController prepLane;
+SequencerController mouldLane;
+MouldScheduler mouldScheduler;
+RecipeEngine recipeEngine;
+CycleProfiler cycleProfiler;
+Adafruit_ADS1115 ads;
+AdcScanController adcScanner;
+HeaterController heaterController;
+SuctionMonitor suctionMonitor;
+MotorMonitor shredderMonitor;
+MotorMonitor mixerMonitor;
+DutyCycleScheduler dutyScheduler;
+PowerBudget powerBudget;
 SimpleServo starchServo;
 
+// ==================== ADS1115 SCAN LIST ====================
+
+// Scan list index of each analog input (same order as adcScanList)
+enum AdcSlot {
+    ADC_SLOT_HEATER_TEMP,
+    ADC_SLOT_VACUUM,
+    ADC_SLOT_SHREDDER_CURRENT,
+    ADC_SLOT_MIXER_CURRENT,
+    ADC_SLOT_COUNT
+};
+
+// Inputs are divided down to the 3.3 V ADC supply - GAIN_ONE covers them
+const AdcChannelConfig adcScanList[ADC_SLOT_COUNT] = {
+    // name              input                        PGA       rate                 median, stage, IIR shift
+    {"Heater Temp",      ADS1115_CH_HEATER_TEMP,      GAIN_ONE, RATE_ADS1115_128SPS, {5, FILTER_STAGE_IIR, 4, 0, 0, 0, 0}},
+    {"Vacuum",           ADS1115_CH_VACUUM,           GAIN_ONE, RATE_ADS1115_475SPS, {3, FILTER_STAGE_IIR, 2, 0, 0, 0, 0}},
+    {"Shredder Current", ADS1115_CH_SHREDDER_CURRENT, GAIN_ONE, RATE_ADS1115_860SPS, {3, FILTER_STAGE_IIR, 3, 0, 0, 0, 0}},
+    {"Mixer Current",    ADS1115_CH_MIXER_CURRENT,    GAIN_ONE, RATE_ADS1115_860SPS, {3, FILTER_STAGE_IIR, 3, 0, 0, 0, 0}}
+};
+
+// Shredder reversing contactor - Forward/Reverse unless that drives the mould carriage
+#if FWD_REV_MOULD_CARRIAGE
+const uint8_t SHREDDER_REVERSE_RELAY = RELAY_IDX_SPARE_3;
+#else
+const uint8_t SHREDDER_REVERSE_RELAY = RELAY_IDX_FORWARD_REVERSE;
+#endif
+
+// ==================== POWER BUDGET ====================
+
+// Supply current of the mains loads; direct-on-line motors draw ~5x while starting.
+// Either shredder contactor can be the one that starts the motor (a jam
+// reversal restarts it on Shredder Power alone), so both reserve the inrush.
+const PowerLoadConfig powerLoads[] = {
+    // name           relay                          inrush A  inrush ms  steady A
+    {"Heater",        RELAY_IDX_HEATER,              10.0f,    200,       9.0f},
+    {"Shredder",      RELAY_IDX_SHREDDER_MAIN_POWER, 30.0f,    1500,      6.0f},
+    {"Shredder Run",  RELAY_IDX_SHREDDER_POWER,      30.0f,    1500,      0.0f},
+    {"Pump",          RELAY_IDX_PUMP,                22.0f,    1000,      4.5f},
+    {"Mixer",         RELAY_IDX_MIXER,               25.0f,    1500,      5.0f},
+    {"Vacuum",        RELAY_IDX_VACUUM,              28.0f,    1500,      5.5f},
+    {"Blower",        RELAY_IDX_BLOWER,              12.0f,    800,       2.5f},
+    {"Conveyor",      RELAY_IDX_CONVEYOR,            4.0f,     300,       1.0f}
+};
+const uint8_t POWER_LOAD_COUNT = sizeof(powerLoads) / sizeof(powerLoads[0]);
+
 // ==================== RELAY STATE TRACKING ====================
 
 // Relay states (true = ON/closed, false = OFF/open)
@@ -60,7 +140,7 @@ const char* relayNames[24] = {
     "Spare 1",              // 0  - PCF8575_1 P0
     "Spare 2",              // 1  - PCF8575_1 P1
     "Linear Door",          // 2  - PCF8575_1 P2
-    "Spare 3",              // 3  - PCF8575_1 P3
+    "Shredder Rev",         // 3  - PCF8575_1 P3
     "Defective",            // 4  - PCF8575_1 P4
     "Conveyor",             // 5  - PCF8575_1 P5
     "Screw",                // 6  - PCF8575_1 P6
@@ -88,35 +168,104 @@ const char* relayNames[24] = {
 // Display callback
 void updateDisplay(const char* line1, const char* line2, bool editing);
 
-// Process functions (to be implemented in future steps)
+// Process functions
 void processAutoRun();
+void processAutoRunButtons(ButtonState enterState, ButtonState upState, ButtonState downState);
+bool startProduction();
+void stopProduction();
 
 // Relay control functions
 void setRelay(uint8_t relayIndex, bool state);
+bool isRelayPending(uint8_t relayIndex);
 void toggleRelay(uint8_t relayIndex);
+void beginRelayBatch();
+void commitRelays();
 
 // ==================== RELAY CONTROL FUNCTIONS ====================
 
-void setRelay(uint8_t relayIndex, bool state) {
+// Port image of each expander (bit set = pin high = relay off). PCF8575 #2
+// P8-P15 stay high so they keep working as inputs.
+uint16_t relayPorts[2] = {0xFFFF, 0xFFFF};
+bool relayPortDirty[2] = {false, false};
+uint8_t relayBatchDepth = 0;
+uint32_t relayChangeCount = 0;
+uint32_t relayWriteCount = 0;
+
+// Whole 16-bit port in one I2C transaction (P0-P7 byte, then P8-P15)
+void writeRelayPort(uint8_t port) {
+    Wire.beginTransmission(port == 0 ? PCF8575_1_ADDRESS : PCF8575_2_ADDRESS);
+    Wire.write(lowByte(relayPorts[port]));
+    Wire.write(highByte(relayPorts[port]));
+    Wire.endTransmission();
+    relayPortDirty[port] = false;
+    relayWriteCount++;
+}
+
+// Switches the relay now - everything else goes through setRelay()
+void driveRelay(uint8_t relayIndex, bool state) {
     if (relayIndex >= 24) return;
     
     relayStates[relayIndex] = state;
     
+    // PCF8575_1 = relays 0-15, PCF8575_2 = relays 16-23 on pins 0-7
+    uint8_t port = (relayIndex < 16) ? 0 : 1;
+    uint16_t mask = 1U << ((relayIndex < 16) ? relayIndex : relayIndex - 16);
+    uint16_t image = relayPorts[port];
+    
     // Relays are active LOW (LOW = ON, HIGH = OFF)
-    uint8_t pinState = state ? LOW : HIGH;
+    relayPorts[port] = state ? (image & ~mask) : (image | mask);
+    relayChangeCount++;
     
-    if (relayIndex < 16) {
-        // PCF8575_1 (relays 0-15)
-        pcf8575_1.digitalWrite(relayIndex, pinState);
+    if (relayBatchDepth == 0) {
+        writeRelayPort(port);
+    } else if (relayPorts[port] != image) {
+        relayPortDirty[port] = true;
+    }
+}
+
+// Rated loads switch on once the supply budget has room for their inrush;
+// turning off is immediate
+void setRelay(uint8_t relayIndex, bool state) {
+    if (relayIndex >= 24) return;
+    
+    if (!state) {
+        powerBudget.turnOff(relayIndex);
+        driveRelay(relayIndex, false);
+    } else if (powerBudget.isRated(relayIndex)) {
+        powerBudget.requestOn(relayIndex);
     } else {
-        // PCF8575_2 (relays 16-23 map to pins 0-7)
-        pcf8575_2.digitalWrite(relayIndex - 16, pinState);
+        driveRelay(relayIndex, true);
+    }
+}
+
+// Switch-on still queued on the supply budget - timed phases wait for it
+bool isRelayPending(uint8_t relayIndex) {
+    return powerBudget.isPending(relayIndex);
+}
+
+// Between begin and commit, relay changes only update the port images;
+// commit writes each changed expander once, however many relays moved
+void beginRelayBatch() {
+    relayBatchDepth++;
+}
+
+void commitRelays() {
+    if (relayBatchDepth > 0) {
+        relayBatchDepth--;
+    }
+    if (relayBatchDepth > 0) return;
+    for (uint8_t port = 0; port < 2; port++) {
+        if (relayPortDirty[port]) {
+            writeRelayPort(port);
+        }
     }
 }
 
 void toggleRelay(uint8_t relayIndex) {
     if (relayIndex >= 24) return;
-    setRelay(relayIndex, !relayStates[relayIndex]);
+    // A start still queued counts as on - toggling cancels it
+    bool on = relayStates[relayIndex] || isRelayPending(relayIndex);
+    setRelay(relayIndex, !on);
     
     // Force menu refresh to show updated state
     menuController.refresh();
@@ -147,6 +296,7 @@ void toggleRelay20() { toggleRelay(20); }
 void toggleRelay21() { toggleRelay(21); }
 void toggleRelay22() { toggleRelay(22); }
 void toggleRelay23() { toggleRelay(23); }
+void toggleShredderReverse() { toggleRelay(SHREDDER_REVERSE_RELAY); }
 
 // Servo control functions
 void setServoAngle(int angle) {
@@ -172,6 +322,10 @@ void toggleServo() {
 
 void startAutoRun() {
     logger.info("AutoRun", "Starting Auto Run...");
+    if (!startProduction()) {
+        displayController.showStatus("Start Failed!", 2000);
+        return;
+    }
     systemRunning = true;
     systemStatus = "Running";
     displayController.showStatus("Starting Auto Run", 2000);
@@ -179,6 +333,7 @@ void startAutoRun() {
 
 void stopAutoRun() {
     logger.info("AutoRun", "Stopping Auto Run...");
+    stopProduction();
     systemRunning = false;
     systemStatus = "Stopped";
     displayController.showStatus("Stopped", 1000);
@@ -188,7 +343,9 @@ void stopAutoRun() {
 void exitTestMode() {
     logger.info("Test", "Exiting Test Mode");
     
-    // Turn off all relays when exiting test mode
+    // Turn off all relays when exiting test mode - and drop starts still
+    // queued on the supply, or they would switch on outside test mode
+    powerBudget.cancelAll();
     for (uint8_t i = 0; i < 24; i++) {
         if (relayStates[i]) {
             setRelay(i, false);
@@ -210,40 +367,411 @@ void resetToDefaults() {
     displayController.showStatus("Reset Defaults", 2000);
 }
 
-// ==================== SCALE CALIBRATION FUNCTIONS ====================
+// ==================== SCALE CALIBRATION WORKFLOW ====================
 
-void calibrateScaleZero() {
-    logger.info("Scale", "Starting zero calibration...");
-    displayController.showStatus("Remove all weight", 2000);
-    delay(2000);
-    displayController.showStatus("Calibrating...", 1000);
+// Calibration runs as a cooperative state machine driven from loop(), so
+// scale sampling, display and buttons keep running while the operator
+// handles weights. UP or DOWN cancels at any step.
+
+enum CalibrationStep {
+    CAL_STEP_IDLE,
+    CAL_STEP_PROMPT,       // Operator instruction, ENTER or timeout continues (flow: ENTER only)
+    CAL_STEP_MEASURING,    // Waiting for the scale to settle
+    CAL_STEP_RESULT        // Showing the outcome
+};
+
+enum CalibrationJob {
+    CAL_JOB_ZERO,
+    CAL_JOB_WEIGHT,
+    CAL_JOB_POINT,         // Extra point for the multi-point table
+    CAL_JOB_TANK_ZERO,     // Pulp tank load cell (second channel)
+    CAL_JOB_TANK_WEIGHT,
+    CAL_JOB_FLOW           // Flow meter K-factor against the scale
+};
+
+CalibrationStep calStep = CAL_STEP_IDLE;
+CalibrationJob calJob = CAL_JOB_ZERO;
+unsigned long calStepStart = 0;
+unsigned long calLastDraw = 0;
+char calResultText[21] = "";
+char calScreen[4][21];
+
+const unsigned long CAL_PROMPT_ZERO_TIME = 2000;    // Time to clear the scale
+const unsigned long CAL_PROMPT_WEIGHT_TIME = 3000;  // Time to place the weight
+const unsigned long CAL_RESULT_TIME = 2000;
+const unsigned long CAL_DRAW_INTERVAL = 250;        // LCD refresh while calibrating
+
+// Flow K-factor calibration: valve fills a container standing on the scale
+FlowKCalibration flowKCal;
+bool flowCalFilling = false;
+unsigned long flowCalLastSample = 0;
+unsigned long flowCalOpenTime = 0;
+unsigned long flowCalCloseTime = 0;
+
+const unsigned long FLOW_CAL_SAMPLE_INTERVAL = 200; // Pulse/mass pair interval
+const unsigned long FLOW_CAL_SETTLE_TIME = 1500;    // Quiet time after closing the valve
+const unsigned long FLOW_CAL_MAX_SETTLE = 10000;
+const float FLOW_CAL_MIN_RATE = 5.0;                // g/s - slower fill times out
+const unsigned long FLOW_CAL_FILL_MARGIN = 10000;   // ms on top of the fill at the minimum rate
+const float FLOW_CAL_MAX_PULSES = 2.0;              // x the pulses the current K expects
+const float FLOW_CAL_MAX_RESIDUAL = 2.0;            // % of the weighed span
+
+bool isCalibrationActive() {
+    return calStep != CAL_STEP_IDLE;
+}
+
+bool isZeroCalibrationJob() {
+    return calJob == CAL_JOB_ZERO || calJob == CAL_JOB_TANK_ZERO;
+}
+
+bool isTankCalibrationJob() {
+    return calJob == CAL_JOB_TANK_ZERO || calJob == CAL_JOB_TANK_WEIGHT;
+}
+
+int calibrationJobWeight() {
+    return isTankCalibrationJob() ? tankCalibrationWeight : scaleCalibrationWeight;
+}
+
+void enterCalibrationStep(CalibrationStep step) {
+    calStep = step;
+    calStepStart = millis();
+    calLastDraw = 0;
+    memset(calScreen, 0, sizeof(calScreen));  // Force a full redraw
+}
+
+void drawCalibrationScreen(const char* line2, uint8_t progress, const char* line4) {
+    unsigned long now = millis();
+    if (calLastDraw != 0 && now - calLastDraw < CAL_DRAW_INTERVAL) return;
+    calLastDraw = now;
+    
+    char lines[4][21];
+    const char* title = "SCALE CALIBRATE";
+    if (calJob == CAL_JOB_ZERO) title = "SCALE ZERO";
+    if (calJob == CAL_JOB_POINT) title = "SCALE ADD POINT";
+    if (calJob == CAL_JOB_TANK_ZERO) title = "TANK ZERO";
+    if (calJob == CAL_JOB_TANK_WEIGHT) title = "TANK CALIBRATE";
+    if (calJob == CAL_JOB_FLOW) title = "FLOW K CALIBRATE";
+    snprintf(lines[0], 21, "%s", title);
+    snprintf(lines[1], 21, "%s", line2);
+    
+    // Progress bar: [############] 100%
+    if (progress > 100) progress = 100;
+    uint8_t filled = progress * 12 / 100;
+    char bar[13];
+    for (uint8_t i = 0; i < 12; i++) {
+        bar[i] = (i < filled) ? '#' : ' ';
+    }
+    bar[12] = '\0';
+    snprintf(lines[2], 21, "[%s] %3d%%", bar, progress);
+    snprintf(lines[3], 21, "%s", line4);
     
-    if (scaleController.calibrateZero()) {
-        scaleController.saveCalibration();
-        displayController.showStatus("Zero Set!", 2000);
-        logger.info("Scale", "Zero calibration successful");
+    // Only touch the LCD when something changed
+    if (memcmp(lines, calScreen, sizeof(lines)) == 0) return;
+    memcpy(calScreen, lines, sizeof(lines));
+    displayController.displayText4Line(lines[0], lines[1], lines[2], lines[3]);
+}
+
+void showCalibrationResult(const char* text) {
+    snprintf(calResultText, 21, "%s", text);
+    enterCalibrationStep(CAL_STEP_RESULT);
+}
+
+void startCalibrationWorkflow(CalibrationJob job) {
+    if (isCalibrationActive()) return;
+    
+    calJob = job;
+    if (job == CAL_JOB_FLOW) {
+        logger.info("Flow", "Starting K-factor calibration...");
     } else {
-        displayController.showStatus("Zero Failed!", 2000);
-        logger.error("Scale", "Zero calibration failed");
+        logger.info("Scale", isZeroCalibrationJob() ? "Starting zero calibration..." : "Starting weight calibration...");
+    }
+    enterCalibrationStep(CAL_STEP_PROMPT);
+}
+
+bool startFlowCalibration() {
+    if (!scaleController.isCalibrated() || !flowMeter.isConnected()) {
+        logger.error("Flow", "Scale and flow meter required for K calibration");
+        return false;
     }
+    if (waterDosing.isActive()) {
+        logger.error("Flow", "Water dosing in progress");
+        return false;
+    }
+    
+    // Tare the empty container and hold the scale at its fast rate
+    scaleController.beginDispense();
+    flowKCal.reset();
+    flowMeter.startBatch();
+    setRelay(RELAY_IDX_VALVE, true);
+    flowCalFilling = true;
+    flowCalLastSample = 0;
+    flowCalOpenTime = millis();
+    logger.info("Flow", "K calibration fill (g)", flowCalAmount);
+    return true;
+}
+
+void stopFlowCalibration() {
+    setRelay(RELAY_IDX_VALVE, false);
+    flowMeter.stopBatch();
+    scaleController.endDispense();
+    flowCalFilling = false;
+}
+
+void finishFlowCalibration() {
+    float netGrams = scaleController.getNetWeight();
+    stopFlowCalibration();
+    
+    FlowKResult result;
+    if (!flowKCal.solve(result)) {
+        logger.error("Flow", "Not enough samples for K fit", (int)result.samples);
+        showCalibrationResult("Cal Failed!");
+        return;
+    }
+    
+    // Static end point as a cross-check of the fitted slope
+    uint32_t pulses = flowMeter.getBatchPulses();
+    float litres = netGrams / FLOW_CAL_WATER_DENSITY / 1000.0f;
+    int endpointK = (litres > 0) ? (int)(pulses / litres) : 0;
+    
+    logger.info("Flow", "Fitted K (pulses/L)", (int)result.kFactor);
+    logger.info("Flow", "End point K (pulses/L)", endpointK);
+    logger.info("Flow", "Fit samples", (int)result.samples);
+    logger.info("Flow", "Residual (0.1g)", (int)(result.residualGrams * 10));
+    logger.info("Flow", "Residual (0.01%)", (int)(result.residualPercent * 100));
+    
+    char line[21];
+    if (result.residualPercent > FLOW_CAL_MAX_RESIDUAL) {
+        logger.error("Flow", "Residual too high, K not applied");
+        snprintf(line, 21, "Noisy! res %d.%02d%%", (int)result.residualPercent,
+                 (int)(result.residualPercent * 100) % 100);
+        showCalibrationResult(line);
+        return;
+    }
+    
+    flowMeter.setKFactor(result.kFactor);
+    flowMeter.saveKFactor();
+    snprintf(line, 21, "K=%d res %d.%02d%%", (int)result.kFactor, (int)result.residualPercent,
+             (int)(result.residualPercent * 100) % 100);
+    showCalibrationResult(line);
+}
+
+void processFlowCalibration(bool cancel) {
+    unsigned long now = millis();
+    float netGrams = scaleController.getNetWeight();
+    char line[21];
+    
+    if (cancel) {
+        stopFlowCalibration();
+        logger.warning("Flow", "K calibration cancelled");
+        showCalibrationResult("Cancelled");
+        return;
+    }
+    
+    if (flowCalFilling) {
+        if (flowMeter.isNoFlowTimeout()) {
+            stopFlowCalibration();
+            logger.error("Flow", "No flow during K calibration");
+            showCalibrationResult("No Flow!");
+            return;
+        }
+        
+        // Water running but not landing on the scale (no container) - close the valve
+        unsigned long maxFill = (unsigned long)(flowCalAmount / FLOW_CAL_MIN_RATE * 1000) + FLOW_CAL_FILL_MARGIN;
+        float maxPulses = flowMeter.getKFactor() * flowCalAmount / FLOW_CAL_WATER_DENSITY / 1000.0f * FLOW_CAL_MAX_PULSES;
+        if (now - flowCalOpenTime >= maxFill || flowMeter.getBatchPulses() > maxPulses) {
+            stopFlowCalibration();
+            logger.error("Flow", "Fill not reaching the scale (g)", (int)netGrams);
+            showCalibrationResult("Fill Timeout!");
+            return;
+        }
+        
+        // Pair pulse count with weighed mass while water is running
+        if (now - flowCalLastSample >= FLOW_CAL_SAMPLE_INTERVAL && flowMeter.isFlowing() &&
+            !scaleController.isSwitchingRate()) {
+            flowKCal.addSample(flowMeter.getBatchPulses(), netGrams);
+            flowCalLastSample = now;
+        }
+        
+        if (netGrams >= flowCalAmount) {
+            setRelay(RELAY_IDX_VALVE, false);
+            flowCalFilling = false;
+            flowCalCloseTime = now;
+        }
+        
+        int progress = (int)(netGrams * 100 / flowCalAmount);
+        snprintf(line, 21, "Filling %dg", (int)netGrams);
+        drawCalibrationScreen(line, progress < 0 ? 0 : progress, "UP/DN=Cancel");
+        return;
+    }
+    
+    // Valve closed - wait for the after-flow and the scale to settle
+    bool quiet = flowMeter.getTimeSinceLastPulse() >= FLOW_CAL_SETTLE_TIME &&
+                 now - flowCalCloseTime >= FLOW_CAL_SETTLE_TIME &&
+                 !scaleController.getFilter().isSettling();
+    if (quiet || now - flowCalCloseTime >= FLOW_CAL_MAX_SETTLE) {
+        finishFlowCalibration();
+        return;
+    }
+    drawCalibrationScreen("Settling...", 100, "UP/DN=Cancel");
+}
+
+void processCalibration(ButtonState enterState, ButtonState upState, ButtonState downState) {
+    bool cancel = (upState == BUTTON_PRESSED || downState == BUTTON_PRESSED);
+    bool confirm = (enterState == BUTTON_PRESSED);
+    unsigned long elapsed = millis() - calStepStart;
+    char line[21];
+    
+    switch (calStep) {
+        case CAL_STEP_PROMPT: {
+            unsigned long promptTime = isZeroCalibrationJob() ? CAL_PROMPT_ZERO_TIME : CAL_PROMPT_WEIGHT_TIME;
+            
+            if (cancel) {
+                logger.warning("Scale", "Calibration cancelled");
+                showCalibrationResult("Cancelled");
+                break;
+            }
+            
+            // The flow job opens the water valve - only the operator starts it
+            if (confirm || (calJob != CAL_JOB_FLOW && elapsed >= promptTime)) {
+                bool started;
+                ScaleChannel channel = isTankCalibrationJob() ? SCALE_CHANNEL_TANK : SCALE_CHANNEL_STARCH;
+                if (calJob == CAL_JOB_FLOW) {
+                    started = startFlowCalibration();
+                } else if (isZeroCalibrationJob()) {
+                    started = scaleController.beginZeroCalibration(channel);
+                } else if (calJob == CAL_JOB_POINT) {
+                    started = scaleController.beginPointCalibration(scaleCalibrationWeight);
+                } else {
+                    started = scaleController.beginWeightCalibration(calibrationJobWeight(), channel);
+                }
+                if (started) {
+                    enterCalibrationStep(CAL_STEP_MEASURING);
+                } else {
+                    showCalibrationResult(isZeroCalibrationJob() ? "Zero Failed!" : "Cal Failed!");
+                }
+                break;
+            }
+            
+            if (calJob == CAL_JOB_FLOW) {
+                snprintf(line, 21, "Empty container on");
+            } else if (calJob == CAL_JOB_TANK_ZERO) {
+                snprintf(line, 21, "Empty the tank");
+            } else if (isZeroCalibrationJob()) {
+                snprintf(line, 21, "Remove all weight");
+            } else {
+                snprintf(line, 21, "Place %dg weight", calibrationJobWeight());
+            }
+            drawCalibrationScreen(line, 0, "ENT=Go  UP/DN=Cancel");
+            break;
+        }
+        
+        case CAL_STEP_MEASURING: {
+            if (calJob == CAL_JOB_FLOW) {
+                processFlowCalibration(cancel);
+                break;
+            }
+            
+            if (cancel) {
+                scaleController.cancelCalibration();
+                showCalibrationResult("Cancelled");
+                break;
+            }
+            
+            ScaleCalState state = scaleController.getCalibrationState();
+            uint8_t confidence = scaleController.getLastCalibrationResult().confidence;
+            
+            if (state == SCALE_CAL_DONE) {
+                scaleController.saveCalibration();
+                if (isZeroCalibrationJob()) {
+                    snprintf(line, 21, "Zero Set! %d%%", confidence);
+                    logger.info("Scale", "Zero calibration successful");
+                } else if (calJob == CAL_JOB_POINT) {
+                    snprintf(line, 21, "%d Points! %d%%", scaleController.getCalibrationTable().getCount(), confidence);
+                    logger.info("Scale", "Calibration point added");
+                } else {
+                    snprintf(line, 21, "Calibrated! %d%%", confidence);
+                    logger.info("Scale", "Calibration successful");
+                }
+                showCalibrationResult(line);
+            } else if (state == SCALE_CAL_FAILED) {
+                logger.error("Scale", isZeroCalibrationJob() ? "Zero calibration failed" : "Calibration failed");
+                showCalibrationResult(isZeroCalibrationJob() ? "Zero Failed!" : "Cal Failed!");
+            } else {
+                drawCalibrationScreen("Settling...", scaleController.getCalibrationProgress(), "UP/DN=Cancel");
+            }
+            break;
+        }
+        
+        case CAL_STEP_RESULT:
+            if (confirm || cancel || elapsed >= CAL_RESULT_TIME) {
+                calStep = CAL_STEP_IDLE;
+                menuController.refresh();
+                break;
+            }
+            drawCalibrationScreen(calResultText, 100, "");
+            break;
+        
+        case CAL_STEP_IDLE:
+        default:
+            break;
+    }
+}
+
+// ==================== TRAY TRACKING ====================
+
+void onTrayEvent(TrayEvent event) {
+    if (event == TRAY_EVENT_ARRIVED) {
+        rejectController.onTrayDetected(traySensor.getTrayCount(), traySensor.getLastLeadingEdge());
+    }
+}
+
+// ==================== WATER DOSING ====================
+
+void startWaterDose() {
+    if (waterDosing.isActive()) {
+        waterDosing.abort();
+        return;
+    }
+    if (waterDosing.start(waterAmount)) {
+        displayController.showStatus("Dosing Water...", 1000);
+    } else {
+        displayController.showStatus("Dose Failed!", 2000);
+    }
+}
+
+void calibrateScaleZero() {
+    startCalibrationWorkflow(CAL_JOB_ZERO);
 }
 
 void calibrateScaleWithWeight() {
-    logger.info("Scale", "Starting weight calibration...");
-    
-    char msg[21];
-    snprintf(msg, 21, "Place %dg weight", scaleCalibrationWeight);
-    displayController.showStatus(msg, 3000);
-    delay(3000);
-    displayController.showStatus("Calibrating...", 1000);
-    
-    if (scaleController.calibrateKnownWeight(scaleCalibrationWeight)) {
-        scaleController.saveCalibration();
-        displayController.showStatus("Calibrated!", 2000);
-        logger.info("Scale", "Calibration successful");
+    startCalibrationWorkflow(CAL_JOB_WEIGHT);
+}
+
+void calibrateScaleAddPoint() {
+    startCalibrationWorkflow(CAL_JOB_POINT);
+}
+
+void calibrateTankZero() {
+    startCalibrationWorkflow(CAL_JOB_TANK_ZERO);
+}
+
+void calibrateTankWithWeight() {
+    startCalibrationWorkflow(CAL_JOB_TANK_WEIGHT);
+}
+
+void calibrateFlowMeter() {
+    startCalibrationWorkflow(CAL_JOB_FLOW);
+}
+
+void heaterAutoTune() {
+    if (systemRunning) return;
+    if (heaterController.isAutoTuning()) {
+        heaterController.cancelAutoTune();
+        displayController.showStatus("Auto-Tune Stopped", 2000);
+    } else if (heaterController.startAutoTune(dryingTemp)) {
+        displayController.showStatus("Auto-Tuning...", 2000);
     } else {
-        displayController.showStatus("Cal Failed!", 2000);
-        logger.error("Scale", "Calibration failed");
+        displayController.showStatus("No Temp Sensor!", 2000);
     }
 }
 
@@ -252,6 +780,1001 @@ void saveScaleCalibration() {
     displayController.showStatus("Scale Cal Saved!", 2000);
 }
 
+// ==================== PRODUCTION SEQUENCE ====================
+
+// Production runs as two pipelined lanes of resumable steps driven from
+// loop(); no step blocks. The prep lane fills the vat for batch N+1 while
+// the mould lane moulds, dries and conveys batch N. The full vat is the
+// hand-off between them. Pause/fault switch every output off and the step
+// is re-entered with resumed = true, picking up where it left off.
+// The steps of both lanes come from the selected recipe (RecipeConfig).
+
+// Resource groups - a step owns its groups for as long as it runs
+#define RES_WATER       0x0001      // Water valve
+#define RES_STARCH      0x0002      // Starch gate and dispensing scale
+#define RES_SHREDDER    0x0004
+#define RES_MIXER       0x0008
+#define RES_VAT         0x0010      // Mixing vat contents
+#define RES_PUMP        0x0020
+#define RES_MOULD       0x0040      // Up/down, vacuum, blower and mould selectors
+#define RES_HEATER      0x0080
+#define RES_CONVEYOR    0x0100
+#define RES_AUX         0x0200      // Any other relay in a recipe frame
+
+bool vatFull = false;                   // Prepared pulp waiting for the pump
+uint8_t batchesInFlight = 0;            // Pipeline depth
+uint8_t batchDefects = DEFECT_NONE;     // Prep lane batch verdict
+uint8_t mouldDefects = DEFECT_NONE;     // Verdict of the batch being moulded
+float waterDelivered = 0;               // ml delivered before a pause/fault
+float starchDelivered = 0;              // g dispensed before a pause/fault
+bool starchGateClosed = false;
+unsigned long starchCloseTime = 0;
+uint32_t conveyorStartCount = 0;
+unsigned long conveyorTrayTime = 0;     // Step time the batch tray reached the sensor
+unsigned long conveyorTrayRun = 0;      // Conveyor run time at that point
+uint8_t conveyorVerdict = DEFECT_NONE;  // Verdict queued for the batch tray
+bool conveyorTraySeen = false;
+const char* stepFaultReason = "";
+bool dryingPreheat = false;             // Heater on ahead of the next tray
+unsigned long mixSavedMs = 0;           // Mixing time saved by the current end-point
+uint32_t mixEndpoints = 0;
+int profiledRecipe = -1;                // Recipe the phase histograms belong to
+
+const float SEQ_WATER_TOLERANCE = 1.0;          // % of waterAmount
+const float SEQ_STARCH_TOLERANCE = 2.0;         // % of starchWeight
+const unsigned long SEQ_WATER_MIN_RATE = 5;     // ml/s - slower than this is a fault
+const unsigned long SEQ_WATER_NOMINAL_RATE = 100;   // ml/s - valve at full mains flow (6 l/min)
+const unsigned long SEQ_STARCH_NOMINAL_RATE = 100;  // g/s - gate fully open
+const unsigned long SEQ_STARCH_SETTLE_TIME = 1000;
+const unsigned long SEQ_CONVEYOR_TIMEOUT = 30000;   // Tray must reach the IR sensor
+const unsigned long RUN_DRAW_INTERVAL = 250;
+const unsigned long PREHEAT_MARGIN = 15000;     // ms - started this much earlier than the model says
+const unsigned long PREHEAT_HYSTERESIS = 30000; // ms - arrival must move this far out to switch back off
+const unsigned long RUN_OEE_INTERVAL = 4000;    // Run screen header alternates
+const unsigned long SHRED_RUNDOWN_TIME = 1500;  // ms power off before the direction changes
+const unsigned long SHRED_CHANGEOVER_TIME = 200; // ms between the direction change and power on
+const unsigned long SHRED_REVERSE_TIME = 3000;  // ms reverse run to clear a jam
+const uint8_t SHRED_MAX_RETRIES = 3;            // Reversals per step before it faults
+const unsigned long MIX_MIN_PERCENT = 40;       // Mixing runs at least this share of the mix time
+const unsigned long MIXER_DUTY_WINDOW = 20000;  // ms - Mix Speed on/off window
+const unsigned long MIXER_MIN_DWELL = 4000;     // ms - shortest motor run or rest
+const unsigned long CONVEYOR_DUTY_WINDOW = 4000;    // ms - Conveyor Speed on/off window
+const unsigned long CONVEYOR_MIN_DWELL = 500;
+
+unsigned long runLastDraw = 0;
+char runScreen[4][21];
+
+// Every production output off; reject relays are released by the tracker
+// and the mould carriage stays where it is. The heater is switched off
+// through its controller so its cached relay state stays in step.
+void allOutputsOff() {
+    heaterController.cancelAutoTune();
+    heaterController.setEnabled(false);
+    resourceArbiter.releaseAll();
+    dutyScheduler.allOff();
+    powerBudget.cancelAll();
+    if (waterDosing.isActive()) {
+        waterDosing.abort();
+    }
+    waterDosing.acknowledge();
+    if (servoAngle != 0) {
+        setServoAngle(0);
+    }
+    if (scaleController.isDispensing()) {
+        scaleController.endDispense();
+    }
+    for (uint8_t i = 0; i < 24; i++) {
+        if (i == RELAY_IDX_DEFECTIVE_1 || i == RELAY_IDX_DEFECTIVE_2) continue;
+#if FWD_REV_MOULD_CARRIAGE
+        if (i == RELAY_IDX_FORWARD_REVERSE) continue;   // Mould position, held by the scheduler
+#endif
+        if (relayStates[i]) {
+            setRelay(i, false);
+        }
+    }
+}
+
+// Recipe frames hand speed-controlled outputs to the duty cycle scheduler
+void recipeRelay(uint8_t relayIndex, bool state) {
+    if (dutyScheduler.owns(relayIndex)) {
+        dutyScheduler.setActive(relayIndex, state);
+    } else {
+        setRelay(relayIndex, state);
+    }
+}
+
+// --- Water fill (closed-loop dose) ---
+
+void waterBegin(uint32_t target, bool resumed) {
+    if (!resumed) {
+        waterDelivered = 0;
+    }
+    float remaining = target - waterDelivered;
+    if (remaining > 0) {
+        waterDosing.start(remaining);
+    }
+}
+
+StepResult waterCheck(uint32_t target) {
+    if (waterDelivered >= target) return STEP_DONE;
+
+    if (waterDosing.isDone()) {
+        float total = waterDelivered + waterDosing.getLastResult().deliveredMl;
+        if (fabs(total - target) > target * SEQ_WATER_TOLERANCE / 100.0f) {
+            logger.warning("AutoRun", "Water dose out of tolerance (ml)", (int)total);
+            batchDefects |= DEFECT_WATER_DOSE;
+        }
+        waterDelivered = total;
+        waterDosing.acknowledge();
+        return STEP_DONE;
+    }
+    if (waterDosing.isFailed() || !waterDosing.isActive()) {
+        waterDelivered += waterDosing.getDeliveredMl();
+        waterDosing.acknowledge();
+        stepFaultReason = "Water dose failed";
+        return STEP_FAULT;
+    }
+    return STEP_RUNNING;
+}
+
+void waterFinish() {
+    if (waterDosing.isActive()) {
+        waterDelivered += waterDosing.getDeliveredMl();
+        waterDosing.abort();
+    }
+    waterDosing.acknowledge();
+}
+
+// --- Starch dispense (servo gate, weighed on the scale) ---
+
+void starchBegin(uint32_t target, bool resumed) {
+    if (!resumed) {
+        starchDelivered = 0;
+    }
+    scaleController.beginDispense();
+    if (starchDelivered >= target) {
+        // Dose completed before the pause - just re-check the settled weight
+        starchGateClosed = true;
+        starchCloseTime = millis();
+        return;
+    }
+    starchGateClosed = false;
+    setServoAngle(240);     // Open
+}
+
+StepResult starchCheck(uint32_t target) {
+    if (!scaleController.isCalibrated()) {
+        stepFaultReason = "Scale not calibrated";
+        return STEP_FAULT;
+    }
+
+    float total = starchDelivered + scaleController.getNetWeight();
+
+    if (!starchGateClosed) {
+        if (total >= target) {
+            setServoAngle(0);
+            starchGateClosed = true;
+            starchCloseTime = millis();
+        }
+        return STEP_RUNNING;
+    }
+
+    // Let the falling starch land before judging the dose
+    if (millis() - starchCloseTime < SEQ_STARCH_SETTLE_TIME) return STEP_RUNNING;
+
+    if (fabs(total - target) > target * SEQ_STARCH_TOLERANCE / 100.0f) {
+        logger.warning("AutoRun", "Starch weight out of tolerance (g)", (int)total);
+        batchDefects |= DEFECT_STARCH_WEIGHT;
+    }
+    starchDelivered = total;
+    return STEP_DONE;
+}
+
+void starchFinish() {
+    setServoAngle(0);
+    if (!starchGateClosed || millis() - starchCloseTime < SEQ_STARCH_SETTLE_TIME) {
+        starchDelivered += scaleController.getNetWeight();
+    }
+    scaleController.endDispense();
+}
+
+// --- Moulding (single mould A, or A/B ping-pong) ---
+
+void mouldBegin(uint32_t suctionSeconds, bool resumed) {
+    mouldScheduler.setDualMode(dualMould);
+    mouldScheduler.setTimings(suctionSeconds * 1000UL, mouldBlowerTime * 1000UL, mouldCycleDelay * 1000UL);
+    if (resumed) {
+        mouldScheduler.resume();
+    } else {
+        mouldScheduler.startCycle(mouldDefects);
+    }
+}
+
+StepResult mouldCheck() {
+    mouldScheduler.update();
+    return mouldScheduler.isCycleDone() ? STEP_DONE : STEP_RUNNING;
+}
+
+void mouldFinish() {
+    if (mouldScheduler.isCycleActive()) {
+        mouldScheduler.abort();
+    }
+}
+
+// --- Conveyor: carry the tray past the IR sensor and both reject stations ---
+
+void trayBegin(bool resumed) {
+    if (!resumed) {
+        conveyorVerdict = mouldScheduler.getReleasedDefects();
+        conveyorStartCount = traySensor.getTrayCount();
+        conveyorTraySeen = false;
+    }
+    if (!conveyorTraySeen) {
+        rejectController.queueVerdict(conveyorVerdict);
+    } else if (resumed) {
+        // Tray position is unknown after a stop - run the full travel again
+        conveyorTrayTime = mouldLane.getStepElapsed();
+        conveyorTrayRun = dutyScheduler.getOnTime(RELAY_IDX_CONVEYOR);
+    }
+}
+
+// Conveyor run time from the IR sensor until the last reject pulse ends
+unsigned long conveyorTravelTime() {
+    int distance = (rejectDistance1 > rejectDistance2) ? rejectDistance1 : rejectDistance2;
+    return (unsigned long)(distance + rejectPulseTime);
+}
+
+// Step time a run time takes at the set conveyor speed (belt pulses below 100%)
+unsigned long atConveyorSpeed(unsigned long runMs) {
+    return (conveyorSpeed > 0) ? runMs * 100UL / conveyorSpeed : runMs;
+}
+
+// Travel is measured in belt run time, not step time
+StepResult trayCheck(unsigned long elapsedMs) {
+    unsigned long run = dutyScheduler.getOnTime(RELAY_IDX_CONVEYOR);
+    if (!conveyorTraySeen) {
+        if (traySensor.getTrayCount() == conveyorStartCount) return STEP_RUNNING;
+        conveyorTraySeen = true;
+        conveyorTrayTime = elapsedMs;
+        conveyorTrayRun = run;
+    }
+    return (run - conveyorTrayRun >= conveyorTravelTime()) ? STEP_DONE : STEP_RUNNING;
+}
+
+unsigned long conveyorTimeout() {
+    // Until the tray is seen, then long enough to clear the last station
+    if (!conveyorTraySeen) return atConveyorSpeed(SEQ_CONVEYOR_TIMEOUT);
+    return conveyorTrayTime + atConveyorSpeed(conveyorTravelTime() + SEQ_CONVEYOR_TIMEOUT);
+}
+
+void trayFinish() {
+    // Step left before the tray reached the sensor - its verdict must not tag the next tray
+    if (!conveyorTraySeen && traySensor.getTrayCount() == conveyorStartCount) {
+        rejectController.withdrawVerdict();
+    }
+}
+
+// --- Drying (PID heater at the drying temperature) ---
+
+void dryBegin() {
+    heaterController.setSetpoint(dryingTemp);
+    heaterController.setEnabled(true);
+}
+
+StepResult dryCheck(uint32_t seconds, unsigned long elapsedMs) {
+    if (heaterController.isFault()) {
+        stepFaultReason = "Heater fault";
+        return STEP_FAULT;
+    }
+    return (elapsedMs >= seconds * 1000UL) ? STEP_DONE : STEP_RUNNING;
+}
+
+// --- Shredding (reverses out of a jam, then retries) ---
+
+enum ShredPhase {
+    SHRED_FORWARD,
+    SHRED_STOPPING,         // Power off, motor running down
+    SHRED_TO_REVERSE,       // Direction contactor changing over, power still off
+    SHRED_REVERSING,
+    SHRED_RESTARTING,       // Power off again before forward
+    SHRED_TO_FORWARD
+};
+
+ShredPhase shredPhase = SHRED_FORWARD;
+unsigned long shredPhaseStart = 0;
+unsigned long shredJamTime = 0;
+unsigned long shredReverseMs = 0;       // Step time not shredding forward (jams, queued starts)
+uint8_t shredRetries = 0;
+
+void enterShredPhase(ShredPhase phase) {
+    shredPhase = phase;
+    shredPhaseStart = millis();
+}
+
+void shredBegin(bool resumed) {
+    if (!resumed) {
+        shredReverseMs = 0;
+        shredRetries = 0;
+    }
+    // Frame powers the motor forward - a reversal cut short by a pause is dropped
+    enterShredPhase(SHRED_FORWARD);
+}
+
+StepResult shredCheck(uint32_t seconds, unsigned long elapsedMs) {
+    unsigned long inPhase = millis() - shredPhaseStart;
+
+    switch (shredPhase) {
+        case SHRED_FORWARD:
+            // Inrush blanking and the shredding time start once both contactors have actually closed
+            if (!relayStates[RELAY_IDX_SHREDDER_POWER] || !relayStates[RELAY_IDX_SHREDDER_MAIN_POWER]) {
+                shredReverseMs += inPhase;
+                shredPhaseStart = millis();
+                return STEP_RUNNING;
+            }
+            if (!shredderMonitor.isRunning()) {
+                shredderMonitor.begin();
+            }
+            if (shredderMonitor.isOvercurrent()) {
+                if (shredRetries >= SHRED_MAX_RETRIES) {
+                    stepFaultReason = "Shredder jam";
+                    return STEP_FAULT;
+                }
+                shredRetries++;
+                logger.warning("AutoRun", "Shredder jam, reversing", (int)shredRetries);
+                shredderMonitor.end(false);
+                setRelay(RELAY_IDX_SHREDDER_POWER, false);
+                shredJamTime = millis();
+                enterShredPhase(SHRED_STOPPING);
+                return STEP_RUNNING;
+            }
+            // Only forward running counts towards the shredding time
+            return (elapsedMs - shredReverseMs >= seconds * 1000UL) ? STEP_DONE : STEP_RUNNING;
+
+        case SHRED_STOPPING:
+            if (inPhase >= SHRED_RUNDOWN_TIME) {
+                setRelay(SHREDDER_REVERSE_RELAY, true);
+                enterShredPhase(SHRED_TO_REVERSE);
+            }
+            break;
+
+        case SHRED_TO_REVERSE:
+            if (inPhase >= SHRED_CHANGEOVER_TIME) {
+                setRelay(RELAY_IDX_SHREDDER_POWER, true);
+                enterShredPhase(SHRED_REVERSING);
+            }
+            break;
+
+        case SHRED_REVERSING:
+            if (!relayStates[RELAY_IDX_SHREDDER_POWER]) {
+                shredPhaseStart = millis();     // Reverse time runs from the contactor closing
+            } else if (inPhase >= SHRED_REVERSE_TIME) {
+                setRelay(RELAY_IDX_SHREDDER_POWER, false);
+                enterShredPhase(SHRED_RESTARTING);
+            }
+            break;
+
+        case SHRED_RESTARTING:
+            if (inPhase >= SHRED_RUNDOWN_TIME) {
+                setRelay(SHREDDER_REVERSE_RELAY, false);
+                enterShredPhase(SHRED_TO_FORWARD);
+            }
+            break;
+
+        case SHRED_TO_FORWARD:
+            if (inPhase >= SHRED_CHANGEOVER_TIME) {
+                setRelay(RELAY_IDX_SHREDDER_POWER, true);
+                shredReverseMs += millis() - shredJamTime;
+                enterShredPhase(SHRED_FORWARD);
+            }
+            break;
+    }
+    return STEP_RUNNING;
+}
+
+void shredFinish() {
+    // Frame has already cut the power - the contactor is switched dead
+    setRelay(SHREDDER_REVERSE_RELAY, false);
+    shredderMonitor.end(false);     // Already ended by recipeComplete if the step ran out
+    if (shredPhase != SHRED_FORWARD) {
+        shredReverseMs += millis() - shredJamTime;
+        shredPhase = SHRED_FORWARD;
+    }
+}
+
+// --- Mixing (ends once the load current settles) ---
+
+// Current is only judged while the duty cycle has the motor on; the rests
+// pause one run per step, so short on-spans still add up to a stable verdict
+void trackMixerRun() {
+    bool on = relayStates[RELAY_IDX_MIXER];
+    if (on && !mixerMonitor.isRunning()) {
+        mixerMonitor.begin();
+    } else if (on && mixerMonitor.isPaused()) {
+        mixerMonitor.resume();
+    } else if (!on && mixerMonitor.isRunning()) {
+        mixerMonitor.pause();
+    }
+}
+
+StepResult mixCheck(uint32_t seconds, unsigned long elapsedMs) {
+    trackMixerRun();
+    if (mixerMonitor.isOvercurrent()) {
+        stepFaultReason = "Mixer overload";
+        return STEP_FAULT;
+    }
+
+    unsigned long mixLimit = seconds * 1000UL;
+    if (elapsedMs >= mixLimit) return STEP_DONE;
+
+    // Steady load = pulp broken down; the mix time is the upper bound
+    if (mixAutoEnd && elapsedMs >= mixLimit * MIX_MIN_PERCENT / 100 && mixerMonitor.isStable()) {
+        mixSavedMs += mixLimit - elapsedMs;
+        mixEndpoints++;
+        logger.debug("AutoRun", "Mix end-point, saved (s)", (int)((mixLimit - elapsedMs) / 1000));
+        return STEP_DONE;
+    }
+    return STEP_RUNNING;
+}
+
+// --- Recipe executor hooks ---
+
+void recipeBegin(const RecipeStep& step, uint32_t value, bool resumed) {
+    switch (step.end) {
+        case RECIPE_END_WATER:  waterBegin(value, resumed); break;
+        case RECIPE_END_STARCH: starchBegin(value, resumed); break;
+        case RECIPE_END_MOULD:  mouldBegin(value, resumed); break;
+        case RECIPE_END_TRAY:   trayBegin(resumed); break;
+        case RECIPE_END_DRY:    dryBegin(); break;
+        case RECIPE_END_SHRED:  shredBegin(resumed); break;
+        default: break;
+    }
+}
+
+StepResult recipeCheck(const RecipeStep& step, uint32_t value, unsigned long elapsedMs) {
+    switch (step.end) {
+        case RECIPE_END_WATER:     return waterCheck(value);
+        case RECIPE_END_STARCH:    return starchCheck(value);
+        case RECIPE_END_VAT_EMPTY: return vatFull ? STEP_RUNNING : STEP_DONE;
+        case RECIPE_END_VAT_FULL:  return vatFull ? STEP_DONE : STEP_RUNNING;
+        case RECIPE_END_MOULD:     return mouldCheck();
+        case RECIPE_END_TRAY:      return trayCheck(elapsedMs);
+        case RECIPE_END_DRY:       return dryCheck(value, elapsedMs);
+        case RECIPE_END_SHRED:     return shredCheck(value, elapsedMs);
+        case RECIPE_END_MIX:       return mixCheck(value, elapsedMs);
+        default:                   return STEP_DONE;
+    }
+}
+
+void recipeFinish(const RecipeStep& step) {
+    switch (step.end) {
+        case RECIPE_END_WATER:  waterFinish(); break;
+        case RECIPE_END_STARCH: starchFinish(); break;
+        case RECIPE_END_MOULD:  mouldFinish(); break;
+        case RECIPE_END_TRAY:   trayFinish(); break;
+        case RECIPE_END_DRY:    heaterController.setEnabled(false); break;
+        case RECIPE_END_SHRED:  shredFinish(); break;
+        case RECIPE_END_MIX:    mixerMonitor.end(false); break;
+        default: break;
+    }
+}
+
+// Step finished normally - batch bookkeeping carried by the step flags
+void recipeComplete(const RecipeStep& step) {
+    if (step.flags & RECIPE_FLAG_NEW_BATCH) {
+        batchDefects = DEFECT_NONE;
+        batchesInFlight++;
+    }
+    if (step.flags & RECIPE_FLAG_VAT_FILLED) {
+        vatFull = true;         // Batch ready for the mould lane
+    }
+    if (step.flags & RECIPE_FLAG_VAT_DRAINED) {
+        // Vat emptied - the batch and its verdict move to the mould lane
+        mouldDefects = batchDefects;
+        vatFull = false;
+    }
+    if (step.end == RECIPE_END_TRAY) {
+        if (batchesInFlight > 0) {
+            batchesInFlight--;
+        }
+        cycleProfiler.recordTray(mouldScheduler.getReleasedDefects() == DEFECT_NONE);
+    }
+    // Motor signatures learn from full runs only; recipeFinish ends the rest
+    if (step.end == RECIPE_END_MIX) {
+        mixerMonitor.end(true);
+    } else if (step.end == RECIPE_END_SHRED) {
+        shredderMonitor.end(true);
+    }
+}
+
+// First dual-mould cycle only forms a tray - nothing to dry or convey yet
+bool recipeSkip(const RecipeStep& step) {
+    return (step.flags & RECIPE_FLAG_NEEDS_TRAY) && !mouldScheduler.hasReleasedTray();
+}
+
+const RecipeHandlers recipeHandlers = {recipeBegin, recipeCheck, recipeFinish, recipeComplete, recipeSkip};
+
+// Resource groups a recipe step drives - from its end condition, relay frame and flags
+uint16_t recipeStepResources(const RecipeStep& step) {
+    uint16_t resources = 0;
+
+    switch (step.end) {
+        case RECIPE_END_WATER:  resources |= RES_WATER; break;
+        case RECIPE_END_STARCH: resources |= RES_STARCH; break;
+        case RECIPE_END_MOULD:  resources |= RES_MOULD; break;
+        case RECIPE_END_TRAY:   resources |= RES_CONVEYOR; break;
+        case RECIPE_END_DRY:    resources |= RES_HEATER; break;
+        case RECIPE_END_SHRED:  resources |= RES_SHREDDER; break;
+        case RECIPE_END_MIX:    resources |= RES_MIXER; break;
+        default: break;
+    }
+
+    for (uint8_t i = 0; i < 24; i++) {
+        if (!(step.relays & RECIPE_RELAY(i))) continue;
+        if (i == SHREDDER_REVERSE_RELAY) {
+            resources |= RES_SHREDDER;
+            continue;
+        }
+        switch (i) {
+            case RELAY_IDX_VALVE:               resources |= RES_WATER; break;
+            case RELAY_IDX_SHREDDER_POWER:
+            case RELAY_IDX_SHREDDER_MAIN_POWER: resources |= RES_SHREDDER; break;
+            case RELAY_IDX_MIXER:               resources |= RES_MIXER; break;
+            case RELAY_IDX_PUMP:                resources |= RES_PUMP; break;
+            case RELAY_IDX_HEATER:              resources |= RES_HEATER; break;
+            case RELAY_IDX_CONVEYOR:            resources |= RES_CONVEYOR; break;
+            case RELAY_IDX_VACUUM:
+            case RELAY_IDX_BLOWER:
+            case RELAY_IDX_MOULD_A_VAC_BLOW:
+            case RELAY_IDX_VACUUM_AB:
+            case RELAY_IDX_BLOWER_AB:
+            case RELAY_IDX_MOULD_B_VAC_BLOW:
+            case RELAY_IDX_FORWARD_REVERSE:     // Mould carriage (else taken as the shredder reverse)
+            case RELAY_IDX_UP_DOWN:             resources |= RES_MOULD; break;
+            default:                            resources |= RES_AUX; break;
+        }
+    }
+
+    if (step.flags & (RECIPE_FLAG_VAT | RECIPE_FLAG_VAT_FILLED | RECIPE_FLAG_VAT_DRAINED)) {
+        resources |= RES_VAT;
+    }
+    return resources;
+}
+
+StepResult recipeLaneUpdate(uint8_t lane, SequencerController& sequencer, unsigned long elapsedMs) {
+    uint8_t index = sequencer.getStepIndex();
+    stepFaultReason = "";
+    StepResult result = recipeEngine.updateStep(lane, index, elapsedMs);
+
+    if (result == STEP_FAULT) {
+        sequencer.setFaultReason(stepFaultReason);
+    } else if (result == STEP_DONE) {
+        sequencer.setNextStep(recipeEngine.getNextStep(lane, index));
+    }
+    return result;
+}
+
+unsigned long recipeLaneTimeout(uint8_t lane, uint8_t index) {
+    unsigned long timeout = recipeEngine.getTimeout(lane, index);
+    const RecipeStep* step = recipeEngine.getStep(lane, index);
+    if (timeout > 0 || step == nullptr || recipeEngine.isSkipped(lane)) return timeout;
+
+    // Condition defaults when the recipe gives no timeout
+    switch (step->end) {
+        case RECIPE_END_WATER:
+            return recipeEngine.getValue(*step) * 1000UL / SEQ_WATER_MIN_RATE + (unsigned long)waterFlowTimeout * 1000UL;
+        case RECIPE_END_STARCH:
+            return (unsigned long)starchDispenseTime * 1000UL;
+        case RECIPE_END_TRAY:
+            return conveyorTimeout();
+        default:
+            return 0;
+    }
+}
+
+// Duration the recipe asks for, 0 for steps that end on a condition
+unsigned long recipeConfiguredTime(uint8_t lane, uint8_t index) {
+    const RecipeStep* step = recipeEngine.getStep(lane, index);
+    if (step == nullptr) return 0;
+
+    unsigned long value = recipeEngine.getValue(*step);
+    switch (step->end) {
+        case RECIPE_END_TIME:
+        case RECIPE_END_DRY:
+        case RECIPE_END_SHRED:
+        case RECIPE_END_MIX:
+            return value * 1000UL;
+        case RECIPE_END_MOULD: {
+            // Dual mode blows off the other mould during suction
+            unsigned long suction = value * 1000UL;
+            unsigned long blow = (unsigned long)mouldBlowerTime * 1000UL;
+            unsigned long form = dualMould ? ((suction > blow) ? suction : blow) : suction + blow;
+            return form + (unsigned long)mouldCycleDelay * 1000UL;
+        }
+        default:
+            return 0;
+    }
+}
+
+// Best-case step time for OEE performance. Doses run at their nominal rate;
+// steps waiting on a condition (tray sensor, vat full) have no ideal and are
+// left out, so their waiting shows up as lost performance.
+unsigned long recipeIdealStepTime(uint8_t lane, uint8_t index) {
+    const RecipeStep* step = recipeEngine.getStep(lane, index);
+    if (step == nullptr) return 0;
+
+    switch (step->end) {
+        case RECIPE_END_WATER:
+            return recipeEngine.getValue(*step) * 1000UL / SEQ_WATER_NOMINAL_RATE;
+        case RECIPE_END_STARCH:
+            return recipeEngine.getValue(*step) * 1000UL / SEQ_STARCH_NOMINAL_RATE + SEQ_STARCH_SETTLE_TIME;
+        default:
+            return recipeConfiguredTime(lane, index);
+    }
+}
+
+// Ideal tray cycle for OEE performance - the slower lane paces the line
+unsigned long recipeIdealCycleTime() {
+    unsigned long ideal = 0;
+    for (uint8_t lane = 0; lane < RECIPE_LANE_COUNT; lane++) {
+        unsigned long total = 0;
+        for (uint8_t i = 0; i < recipeEngine.getStepCount(lane); i++) {
+            total += recipeIdealStepTime(lane, i);
+        }
+        if (total > ideal) ideal = total;
+    }
+    return ideal;
+}
+
+void recordRecipePhase(uint8_t lane, uint8_t index, unsigned long durationMs) {
+    if (recipeEngine.isSkipped(lane)) return;
+    const RecipeStep* step = recipeEngine.getStep(lane, index);
+    if (step == nullptr) return;
+    cycleProfiler.recordPhase(lane * RECIPE_MAX_STEPS + index, step->name, durationMs,
+                              recipeConfiguredTime(lane, index));
+}
+
+// Sequencer step callbacks carry no context - one set per lane
+void prepStepEnter(bool resumed) {
+    recipeEngine.enterStep(RECIPE_LANE_PREP, prepLane.getStepIndex(), resumed);
+}
+
+StepResult prepStepUpdate(unsigned long elapsedMs) {
+    return recipeLaneUpdate(RECIPE_LANE_PREP, prepLane, elapsedMs);
+}
+
+void prepStepExit() {
+    recipeEngine.exitStep(RECIPE_LANE_PREP, prepLane.getStepIndex());
+}
+
+void prepStepDone(uint8_t index, unsigned long durationMs) {
+    recordRecipePhase(RECIPE_LANE_PREP, index, durationMs);
+}
+
+unsigned long prepStepTimeout() {
+    return recipeLaneTimeout(RECIPE_LANE_PREP, prepLane.getStepIndex());
+}
+
+void mouldStepEnter(bool resumed) {
+    recipeEngine.enterStep(RECIPE_LANE_MOULD, mouldLane.getStepIndex(), resumed);
+}
+
+StepResult mouldStepUpdate(unsigned long elapsedMs) {
+    return recipeLaneUpdate(RECIPE_LANE_MOULD, mouldLane, elapsedMs);
+}
+
+void mouldStepExit() {
+    recipeEngine.exitStep(RECIPE_LANE_MOULD, mouldLane.getStepIndex());
+}
+
+void mouldStepDone(uint8_t index, unsigned long durationMs) {
+    recordRecipePhase(RECIPE_LANE_MOULD, index, durationMs);
+}
+
+unsigned long mouldStepTimeout() {
+    return recipeLaneTimeout(RECIPE_LANE_MOULD, mouldLane.getStepIndex());
+}
+
+// Lane step tables generated from the selected recipe (static - no allocation)
+SequencerStep prepSteps[RECIPE_MAX_STEPS];
+SequencerStep mouldSteps[RECIPE_MAX_STEPS];
+
+void buildLaneSteps(uint8_t lane, SequencerStep* table) {
+    bool prep = (lane == RECIPE_LANE_PREP);
+    for (uint8_t i = 0; i < recipeEngine.getStepCount(lane); i++) {
+        const RecipeStep* step = recipeEngine.getStep(lane, i);
+        table[i].name = step->name;
+        table[i].resources = recipeStepResources(*step);
+        table[i].enter = prep ? prepStepEnter : mouldStepEnter;
+        table[i].update = prep ? prepStepUpdate : mouldStepUpdate;
+        table[i].exit = prep ? prepStepExit : mouldStepExit;
+        table[i].timeoutMs = prep ? prepStepTimeout : mouldStepTimeout;
+    }
+}
+
+bool isRecipeStep(uint8_t recipeLane, uint8_t index, uint8_t end) {
+    const RecipeStep* step = recipeEngine.getStep(recipeLane, index);
+    return step != nullptr && step->end == end;
+}
+
+// --- Drying preheat ---
+
+// Expected time until the lane enters step target (stepCount = end of the
+// batch), from measured step averages or the recipe when there are none
+unsigned long laneTimeTo(SequencerController& lane, uint8_t recipeLane, uint8_t target) {
+    uint8_t count = lane.getStepCount();
+    uint8_t index = lane.getStepIndex();
+    unsigned long remaining = 0;
+
+    for (uint8_t n = 0; n < count && index != target; n++) {
+        unsigned long expected = lane.getStepAverage(index);
+        if (expected == 0) {
+            expected = recipeConfiguredTime(recipeLane, index);
+        }
+
+        const RecipeStep* step = recipeEngine.getStep(recipeLane, index);
+        if (n == 0) {
+            if (step != nullptr && step->end == RECIPE_END_VAT_FULL && !vatFull && &lane == &mouldLane) {
+                // Waiting for pulp - the prep lane decides when this ends
+                expected = laneTimeTo(prepLane, RECIPE_LANE_PREP, prepLane.getStepCount());
+            } else {
+                unsigned long elapsed = lane.getStepElapsed();
+                expected = (expected > elapsed) ? expected - elapsed : 0;
+            }
+        }
+        remaining += expected;
+
+        index++;
+        if (index >= count) {
+            if (target >= count) break;
+            index = 0;
+        }
+    }
+    return remaining;
+}
+
+// Predicted time until the next tray reaches the drying step
+unsigned long predictDryingArrival() {
+    for (uint8_t i = 0; i < mouldLane.getStepCount(); i++) {
+        if (isRecipeStep(RECIPE_LANE_MOULD, i, RECIPE_END_DRY)) {
+            return laneTimeTo(mouldLane, RECIPE_LANE_MOULD, i);
+        }
+    }
+    return HEAT_UP_UNKNOWN;
+}
+
+void endDryingPreheat() {
+    if (!dryingPreheat) return;
+    dryingPreheat = false;
+    heaterController.setEnabled(false);
+}
+
+// Switch the heater on just early enough for the next tray, and off again
+// when the tray is further away than a fresh heat-up takes
+void updateDryingPreheat() {
+    if (prepLane.getState() != SEQ_STATE_RUNNING || mouldLane.getState() != SEQ_STATE_RUNNING) {
+        endDryingPreheat();
+        return;
+    }
+    if (heaterController.isFault()) {
+        // Latched until the operator retries - the drying step faults on it
+        if (dryingPreheat) {
+            dryingPreheat = false;
+            logger.warning("Heater", "Preheat stopped - heater fault");
+        }
+        return;
+    }
+    if (isRecipeStep(RECIPE_LANE_MOULD, mouldLane.getStepIndex(), RECIPE_END_DRY) && !mouldLane.isWaitingForResources()) {
+        if (!recipeEngine.isSkipped(RECIPE_LANE_MOULD)) {
+            dryingPreheat = false;  // Drying step owns the heater now
+        }
+        return;
+    }
+
+    unsigned long arrival = predictDryingArrival();
+    if (arrival == HEAT_UP_UNKNOWN) return;
+
+    unsigned long heatUp = heaterController.getHeatUpTime(dryingTemp);
+    unsigned long lead = (heatUp == HEAT_UP_UNKNOWN) ? HEAT_UP_UNKNOWN : heatUp + heatUp / 5 + PREHEAT_MARGIN;
+
+    if (!dryingPreheat && arrival <= lead) {
+        heaterController.setSetpoint(dryingTemp);
+        heaterController.setEnabled(true);
+        dryingPreheat = true;
+        logger.debug("Heater", "Preheat, tray due in (s)", (int)(arrival / 1000));
+    } else if (dryingPreheat && lead != HEAT_UP_UNKNOWN && arrival > lead + PREHEAT_HYSTERESIS) {
+        endDryingPreheat();
+        logger.debug("Heater", "Preheat off, tray due in (s)", (int)(arrival / 1000));
+    }
+}
+
+// --- Recipe selection (menu) ---
+
+void selectNextRecipe() {
+    if (systemRunning) return;
+    uint8_t index = (recipeEngine.getSelected() + 1) % recipeEngine.getRecipeCount();
+    recipeEngine.select(index);
+
+    char message[21];
+    snprintf(message, sizeof(message), "Recipe: %s", recipeEngine.getActive().name);
+    displayController.showStatus(message, 2000);
+}
+
+void saveCustomRecipe() {
+    if (recipeEngine.saveActiveAsCustom("Custom")) {
+        displayController.showStatus("Recipe Saved!", 2000);
+    } else {
+        displayController.showStatus("Save Failed!", 2000);
+    }
+}
+
+// --- Pipeline control (both lanes move together) ---
+
+bool startProduction() {
+    allOutputsOff();
+    mouldScheduler.reset();
+    rejectController.clear();
+    heaterController.clearFault();
+    vatFull = false;
+    batchesInFlight = 0;
+    
+    // Recipe is fixed for the whole run
+    buildLaneSteps(RECIPE_LANE_PREP, prepSteps);
+    buildLaneSteps(RECIPE_LANE_MOULD, mouldSteps);
+    prepLane.init(prepSteps, recipeEngine.getStepCount(RECIPE_LANE_PREP), nullptr, &resourceArbiter);
+    mouldLane.init(mouldSteps, recipeEngine.getStepCount(RECIPE_LANE_MOULD), nullptr, &resourceArbiter);
+    // Phase slots are step positions - another recipe's steps would land in the same slots
+    if (recipeEngine.getSelected() != profiledRecipe) {
+        cycleProfiler.resetPhases();
+        profiledRecipe = recipeEngine.getSelected();
+    }
+    cycleProfiler.setIdealCycleTime(recipeIdealCycleTime());
+    logger.info("AutoRun", "Recipe", recipeEngine.getActive().name);
+    if (!prepLane.start()) return false;
+    if (!mouldLane.start()) {
+        prepLane.stop();
+        return false;
+    }
+    return true;
+}
+
+void stopProduction() {
+    if (prepLane.isActive()) {
+        prepLane.stop();
+    }
+    if (mouldLane.isActive()) {
+        mouldLane.stop();
+    }
+    endDryingPreheat();
+    allOutputsOff();
+    rejectController.clear();
+}
+
+void pauseProduction() {
+    prepLane.pause();
+    mouldLane.pause();
+    endDryingPreheat();
+    allOutputsOff();
+}
+
+bool isProductionFaulted() {
+    return prepLane.getState() == SEQ_STATE_FAULTED || mouldLane.getState() == SEQ_STATE_FAULTED;
+}
+
+bool resumeProduction() {
+    // Retrying after a fault acknowledges a heater fault
+    if (isProductionFaulted()) {
+        heaterController.clearFault();
+    }
+    bool prepResumed = prepLane.resume();
+    bool mouldResumed = mouldLane.resume();
+    return prepResumed || mouldResumed;
+}
+
+// Bottleneck lane, pipelined vs serial throughput and lane utilization
+void logPipelineStatistics() {
+    prepLane.logStatistics();
+    mouldLane.logStatistics();
+    mouldScheduler.logStatistics();
+    cycleProfiler.logStatistics();
+
+    unsigned long prepBusy = prepLane.getBusyTimePerBatch();
+    unsigned long mouldBusy = mouldLane.getBusyTimePerBatch();
+    logger.debug("Pipeline", "Depth", (int)batchesInFlight);
+    if (mixEndpoints > 0) {
+        logger.debug("Pipeline", "Mix end-points", (int)mixEndpoints);
+        logger.debug("Pipeline", "Mix saved (s)", (int)(mixSavedMs / 1000));
+    }
+    if (prepBusy == 0 || mouldBusy == 0) return;
+
+    // The slowest lane paces the line; in series both lanes add up
+    unsigned long cycle = (prepBusy > mouldBusy) ? prepBusy : mouldBusy;
+    logger.debug("Pipeline", "Bottleneck", (prepBusy > mouldBusy) ? prepLane.getName() : mouldLane.getName());
+    logger.debug("Pipeline", "Trays/hour", (int)(3600000UL / cycle));
+    logger.debug("Pipeline", "Serial trays/hour", (int)(3600000UL / (prepBusy + mouldBusy)));
+}
+
+// One lane on one LCD row: "P Water Fill 450ml"
+void formatLaneLine(char* line, char tag, uint8_t recipeLane, SequencerController& lane) {
+    if (lane.getState() == SEQ_STATE_FAULTED) {
+        snprintf(line, 21, "%c FAULT %s", tag, lane.getFaultReason());
+        return;
+    }
+
+    char detail[10];
+    unsigned long elapsed = lane.getStepElapsed() / 1000;
+    if (lane.isWaitingForResources()) {
+        snprintf(detail, sizeof(detail), "wait");
+    } else if (isRecipeStep(recipeLane, lane.getStepIndex(), RECIPE_END_WATER)) {
+        float delivered = waterDelivered + (waterDosing.isActive() ? waterDosing.getDeliveredMl() : 0);
+        snprintf(detail, sizeof(detail), "%dml", (int)delivered);
+    } else if (isRecipeStep(recipeLane, lane.getStepIndex(), RECIPE_END_STARCH)) {
+        float dispensed = starchDelivered + (scaleController.isDispensing() ? scaleController.getNetWeight() : 0);
+        snprintf(detail, sizeof(detail), "%dg", (int)dispensed);
+    } else if (isRecipeStep(recipeLane, lane.getStepIndex(), RECIPE_END_DRY)) {
+        snprintf(detail, sizeof(detail), "%dC %lus", (int)heaterController.getTemperature(), elapsed);
+    } else if (isRecipeStep(recipeLane, lane.getStepIndex(), RECIPE_END_MOULD)) {
+        snprintf(detail, sizeof(detail), "%s", mouldScheduler.getPhaseName());
+    } else if (isRecipeStep(recipeLane, lane.getStepIndex(), RECIPE_END_SHRED)) {
+        if (shredPhase != SHRED_FORWARD) {
+            snprintf(detail, sizeof(detail), "Rev %d", shredRetries);
+        } else {
+            snprintf(detail, sizeof(detail), "%dA %lus", (int)shredderMonitor.getCurrent(), elapsed);
+        }
+    } else if (isRecipeStep(recipeLane, lane.getStepIndex(), RECIPE_END_MIX)) {
+        snprintf(detail, sizeof(detail), "%dA %lus", (int)mixerMonitor.getCurrent(), elapsed);
+    } else {
+        snprintf(detail, sizeof(detail), "%lus", elapsed);
+    }
+    snprintf(line, 21, "%c %-12.12s %s", tag, lane.getStepName(), detail);
+}
+
+void drawRunScreen() {
+    unsigned long now = millis();
+    if (runLastDraw != 0 && now - runLastDraw < RUN_DRAW_INTERVAL) return;
+    runLastDraw = now;
+
+    char lines[4][21];
+    if ((now / RUN_OEE_INTERVAL) % 2 == 0) {
+        snprintf(lines[0], 21, "AUTO Done:%lu Dep:%d", (unsigned long)mouldLane.getBatchCount(), batchesInFlight);
+    } else {
+        // Alternate header: OEE and trays/hour over the last 1 h / 8 h
+        snprintf(lines[0], 21, "OEE %d%% T/h %u/%u", cycleProfiler.getOEE(),
+                 cycleProfiler.getTraysPerHour1h(), cycleProfiler.getTraysPerHour8h());
+    }
+    formatLaneLine(lines[1], 'P', RECIPE_LANE_PREP, prepLane);
+    formatLaneLine(lines[2], 'M', RECIPE_LANE_MOULD, mouldLane);
+
+    if (isProductionFaulted()) {
+        snprintf(lines[3], 21, "ENT=Retry UP/DN=Stop");
+    } else if (prepLane.getState() == SEQ_STATE_PAUSED) {
+        snprintf(lines[3], 21, "PAUSED ENT=Resume");
+    } else {
+        snprintf(lines[3], 21, "ENT=Pause UP/DN=Stop");
+    }
+
+    // Only touch the LCD when something changed
+    if (memcmp(lines, runScreen, sizeof(lines)) == 0) return;
+    memcpy(runScreen, lines, sizeof(lines));
+    displayController.displayText4Line(lines[0], lines[1], lines[2], lines[3]);
+}
+
+// Run screen owns the buttons: ENTER pauses/resumes (retries after a fault),
+// UP or DOWN stops the machine
+void processAutoRunButtons(ButtonState enterState, ButtonState upState, ButtonState downState) {
+    if (upState == BUTTON_PRESSED || downState == BUTTON_PRESSED) {
+        stopAutoRun();
+        return;
+    }
+    if (enterState != BUTTON_PRESSED) return;
+
+    if (prepLane.getState() == SEQ_STATE_RUNNING && mouldLane.getState() == SEQ_STATE_RUNNING) {
+        pauseProduction();
+        systemStatus = "Paused";
+    } else if (resumeProduction()) {
+        systemStatus = "Running";
+    }
+}
+
 // ==================== DISPLAY CALLBACK ====================
 
 void updateDisplay(const char* line1, const char* line2, bool editing) {
@@ -299,6 +1822,12 @@ void setup() {
         pcf8575_2.digitalWrite(i, HIGH);  // Relay OFF
     }
     
+    // Stagger motor and heater starts within the supply budget
+    powerBudget.init(SUPPLY_BUDGET_AMPS, driveRelay);
+    for (uint8_t i = 0; i < POWER_LOAD_COUNT; i++) {
+        powerBudget.addLoad(powerLoads[i]);
+    }
+    
     // Configure direct GPIO pins for buttons and sensors
     pinMode(BTN_UP, INPUT_PULLUP);
     pinMode(BTN_ENTER, INPUT_PULLUP);
@@ -319,17 +1848,55 @@ void setup() {
     servoAngle = 0;
     logger.info("Servo", "Initialized on pin", SERVO_PIN);
     
-    // Initialize scale controller (NAU7802)
-    if (scaleController.init()) {
-        logger.info("Scale", "NAU7802 initialized successfully");
+    // Initialize scale controller (NAU7802, HX711 fallback)
+    if (scaleController.init(HX711_DOUT_PIN, HX711_SCK_PIN, HX711_RATE_SPS)) {
+        logger.info("Scale", "Initialized with", scaleController.getBackendName());
         if (scaleController.isCalibrated()) {
             logger.info("Scale", "Calibration loaded from Preferences");
         } else {
             logger.warning("Scale", "Not calibrated - please calibrate");
         }
+        // Low noise rate at rest, 320 SPS automatically while the load moves
+        scaleController.setAutoRate(true);
     } else {
-        logger.error("Scale", "NAU7802 initialization failed!");
+        logger.error("Scale", "Load cell initialization failed!");
+    }
+    
+    // Initialize water flow meter (hardware pulse counter on the flow sensor pin)
+    if (!flowMeter.init(SENSOR_WATER_FLOW)) {
+        logger.error("Flow", "Flow meter initialization failed!");
     }
+    waterDosing.init(&flowMeter, RELAY_IDX_VALVE, setRelay);
+    
+    // IR tray detector - edges timestamped in the ISR, counted in loop
+    traySensor.init(SENSOR_IR_TRAY);
+    traySensor.setEventCallback(onTrayEvent);
+    
+    // Reject tracking - trays advance while the conveyor relay is on
+    rejectController.init(setRelay, &relayStates[RELAY_IDX_CONVEYOR]);
+    
+    // Mould A/B - shared vacuum pump and blower behind the A/B selectors
+    MouldRelays mouldRelays;
+    mouldRelays.vacuum = RELAY_IDX_VACUUM;
+    mouldRelays.blower = RELAY_IDX_BLOWER;
+    mouldRelays.vacuumSelect = RELAY_IDX_VACUUM_AB;
+    mouldRelays.blowerSelect = RELAY_IDX_BLOWER_AB;
+    mouldRelays.mouldValve[MOULD_A] = RELAY_IDX_MOULD_A_VAC_BLOW;
+    mouldRelays.mouldValve[MOULD_B] = RELAY_IDX_MOULD_B_VAC_BLOW;
+#if FWD_REV_MOULD_CARRIAGE
+    mouldRelays.position = RELAY_IDX_FORWARD_REVERSE;
+#else
+    mouldRelays.position = MOULD_NO_RELAY;              // No carriage - single mould A
+#endif
+    mouldRelays.lift = RELAY_IDX_UP_DOWN;
+    mouldScheduler.init(setRelay, mouldRelays);
+    mouldScheduler.setPendingCheck(isRelayPending);
+    
+    // Production pipeline - the prep and mould lanes share the resource groups
+    prepLane.setName("Prep");
+    prepLane.setStepCallback(prepStepDone);
+    mouldLane.setName("Mould");
+    mouldLane.setStepCallback(mouldStepDone);
     
     // Test reading direct GPIO pins before button init
     logger.info("GPIO", "Reading button pins before init...");
@@ -354,6 +1921,39 @@ void setup() {
     menuController.setDisplay4LineCallback(updateDisplay4Line);
     logger.info("MENU", "Menu controller initialized");
     
+    // Production recipes - built-ins in flash, custom recipe in Preferences
+    recipeEngine.init(builtInRecipes, BUILTIN_RECIPE_COUNT, recipeSettings, RECIPE_SET_COUNT, recipeRelay, recipeHandlers);
+    recipeEngine.setPendingCheck(isRelayPending);
+    
+    // Mix Speed / Conveyor Speed as on/off windows on the plain motor relays
+    dutyScheduler.init(setRelay);
+    dutyScheduler.setPendingCheck(isRelayPending);
+    dutyScheduler.addOutput(RELAY_IDX_MIXER, MIXER_DUTY_WINDOW, MIXER_MIN_DWELL);
+    dutyScheduler.addOutput(RELAY_IDX_CONVEYOR, CONVEYOR_DUTY_WINDOW, CONVEYOR_MIN_DWELL);
+    
+    // ADS1115 - continuous scan, each conversion read on its ALERT/RDY pulse
+    if (ads.begin(ADS1115_ADDRESS) && adcScanner.init(&ads, ADS1115_ALERT_PIN)) {
+        for (uint8_t i = 0; i < ADC_SLOT_COUNT; i++) {
+            adcScanner.addChannel(adcScanList[i]);
+        }
+        adcScanner.start();
+    } else {
+        logger.error("ADS1115", "ADC not found!");
+    }
+    
+    // Drying heater - NTC on the ADC scan, PID gains from Preferences
+    heaterController.init(&adcScanner, ADC_SLOT_HEATER_TEMP, RELAY_IDX_HEATER, setRelay);
+    heaterController.setPendingCheck(isRelayPending);
+    
+    // Suction end-point on the shared vacuum line
+    suctionMonitor.init(&adcScanner, ADC_SLOT_VACUUM, VACUUM_ZERO_VOLTS, VACUUM_KPA_PER_VOLT);
+    mouldScheduler.setSuctionMonitor(&suctionMonitor);
+    
+    // Motor current signatures - mixer end-point and shredder jam detection
+    shredderMonitor.init(&adcScanner, ADC_SLOT_SHREDDER_CURRENT, SHREDDER_AMPS_PER_VOLT, SHREDDER_JAM_AMPS,
+                         "Shredder", "shredAmps");
+    mixerMonitor.init(&adcScanner, ADC_SLOT_MIXER_CURRENT, MIXER_AMPS_PER_VOLT, MIXER_JAM_AMPS, "Mixer", "mixAmps");
+    
     // Show initial menu
     menuController.refresh();
     
@@ -365,6 +1965,9 @@ void setup() {
 // ==================== MAIN LOOP ====================
 
 void loop() {
+    // Relay changes of this pass go out together at the end
+    beginRelayBatch();
+    
     // Read raw GPIO pin states every second for debugging
     static unsigned long lastRawRead = 0;
     if (millis() - lastRawRead > 1000) {
@@ -398,7 +2001,13 @@ void loop() {
     }
     
     // Handle button inputs
-    if (menuController.getState() == MENU_STATE_BROWSING) {
+    if (isCalibrationActive()) {
+        // Calibration workflow owns the buttons and display
+        processCalibration(enterState, upState, downState);
+    } else if (systemRunning) {
+        // Run screen owns the buttons while the machine runs
+        processAutoRunButtons(enterState, upState, downState);
+    } else if (menuController.getState() == MENU_STATE_BROWSING) {
         // Browsing mode
         if (upState == BUTTON_PRESSED) {
             menuController.navigateUp();
@@ -428,21 +2037,100 @@ void loop() {
         }
     }
     
+    // Pull new load cell samples through the filter chain
+    scaleController.setTemperatureCompensation(scaleTempComp);
+    scaleController.setZeroTracking(scaleZeroTrack, scaleZeroBand, scaleZeroLimit);
+    scaleController.setTankChannel(tankScaleEnabled);
+    scaleController.update();
+    
+    // Read the water flow pulse counter
+    flowMeter.setNoFlowTimeout(waterFlowTimeout * 1000UL);
+    flowMeter.update();
+    waterDosing.update();
+    if (waterDosing.isDone() || waterDosing.isFailed()) {
+        // Manual dose from the menu - report and release (auto run reads its own result)
+        if (!systemRunning) {
+            displayController.showStatus(waterDosing.isDone() ? "Water Dosed" : "Dosing Failed!", 2000);
+            waterDosing.acknowledge();
+        }
+    }
+    traySensor.update();
+    
+    // Material faults reject at Defective 1, moulding/drying faults at Defective 2
+    rejectController.configureStation(0, RELAY_IDX_DEFECTIVE_1, rejectDistance1, rejectPulseTime,
+                                      DEFECT_STARCH_WEIGHT | DEFECT_WATER_DOSE);
+    rejectController.configureStation(1, RELAY_IDX_DEFECTIVE_2, rejectDistance2, rejectPulseTime,
+                                      DEFECT_MOULD_FAULT | DEFECT_DRYING | DEFECT_OTHER);
+    rejectController.update();
+    adcScanner.update();
+    heaterController.update();
+    suctionMonitor.setEnabled(suctionAutoEnd);
+    suctionMonitor.update();
+    shredderMonitor.update();
+    mixerMonitor.update();
+    dutyScheduler.setDuty(RELAY_IDX_MIXER, mixSpeed);
+    dutyScheduler.setDuty(RELAY_IDX_CONVEYOR, conveyorSpeed);
+    dutyScheduler.update();
+    powerBudget.update();
+
+    // Log scale noise/settling and flow statistics every 10 seconds
+    static unsigned long lastScaleStats = 0;
+    if (millis() - lastScaleStats > 10000) {
+        scaleController.logStatistics();
+        flowMeter.logStatistics();
+        traySensor.logStatistics();
+        rejectController.logStatistics();
+        adcScanner.logStatistics();
+        heaterController.logStatistics();
+        suctionMonitor.logStatistics();
+        shredderMonitor.logStatistics();
+        mixerMonitor.logStatistics();
+        dutyScheduler.logStatistics();
+        powerBudget.logStatistics();
+        logger.verbose("Relay", "Changes", (int)relayChangeCount);
+        logger.verbose("Relay", "Port writes", (int)relayWriteCount);
+        if (systemRunning) {
+            logPipelineStatistics();
+        }
+        lastScaleStats = millis();
+    }
+
     // Update display cursor blinking
     displayController.update();
     
     // Check display health and recover if needed
     displayController.checkHealth();
     
+    // OEE availability - scheduled time split into running and down (paused/faulted)
+    if (!systemRunning) {
+        cycleProfiler.setState(PROFILER_STOPPED);
+    } else if (prepLane.getState() == SEQ_STATE_RUNNING && mouldLane.getState() == SEQ_STATE_RUNNING) {
+        cycleProfiler.setState(PROFILER_RUNNING);
+    } else {
+        cycleProfiler.setState(PROFILER_DOWN);
+    }
+    
     // Process auto run if running
     if (systemRunning) {
         processAutoRun();
     }
+    
+    commitRelays();
 }
 
 // ==================== PROCESS FUNCTIONS ====================
 
 void processAutoRun() {
-    // Auto run process will be implemented in next phase
-    // This is where the automatic sequence will execute
+    prepLane.update();
+    mouldLane.update();
+    updateDryingPreheat();
+    
+    // A fault in either lane holds the whole line in the safe state
+    if (isProductionFaulted() && systemStatus != "Fault") {
+        prepLane.pause();
+        mouldLane.pause();
+        allOutputsOff();
+        systemStatus = "Fault";
+    }
+    drawRunScreen();
 }